@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <vector>
+
+#include "config.h"
+
+namespace Benchmark
+{
+    /**
+     * Run all the benchmarks and print the results to the serial console.
+     * Does nothing unless BENCHMARK_ENABLED is defined.
+     */
+    void run();
+
+    void runTransport();
+    void runParser();
+    void runEncoder();
+    void runCrypto();
+
+    /**
+     * CTAP request as sent by the clients, shared by the parser benchmarks on the device and on the host
+     */
+    struct CorpusEntry
+    {
+        const char *name;
+        // list length or subcommand
+        uint32_t parameter;
+        std::vector<uint8_t> request;
+    };
+
+    void buildCorpus(std::vector<CorpusEntry> &corpus);
+
+    // helpers
+    uint32_t percentile(std::vector<uint32_t> &samples, const uint8_t percent);
+    void printLatency(const char *name, std::vector<uint32_t> &samples);
+} // namespace Benchmark
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <esp_bt_defs.h>
+
+namespace BLE
+{
+    /**
+     * Connection parameters policy: short connection interval while a transaction is in flight,
+     * long low-power interval when the connection is idle.
+     */
+    namespace Connection
+    {
+        void init();
+
+        void onConnect(const esp_bd_addr_t address);
+        void onDisconnect();
+
+        void beginTransaction();
+        void endTransaction();
+    } // namespace Connection
+} // namespace BLE
\ No newline at end of file
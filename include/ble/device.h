@@ -13,6 +13,7 @@ namespace BLE
     class Server : public BLEServerCallbacks
     {
         void onConnect(BLEServer *pServer);
+        void onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param);
         void onDisconnect(BLEServer *pServer);
     };
 } // namespace BLE
\ No newline at end of file
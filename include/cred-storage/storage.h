@@ -1,19 +1,22 @@
 #pragma once
 
+#include "config.h"
 #include "util/fixedbuffer.h"
 
 namespace CredentialsStorage
 {
     struct Credential
     {
-        FixedBuffer32 id;
+        // the wrapped credential key, see FIDO2::Authenticator::wrapKey
+        uint8_t id[CREDENTIAL_ID_LENGTH];
         String rpId;
         FixedBuffer64 userId;
     };
 
     void reset();
 
-    bool getCredential(const FixedBuffer32 &credentialId, Credential **credential);
+    // the first credential stored for the RP
+    bool findCredential(const String &rpId, Credential **credential);
 
     bool findCredential(const String &rpId, const FixedBuffer64 &userId, Credential **credential);
 
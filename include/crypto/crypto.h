@@ -4,16 +4,95 @@
 
 #include "config.h"
 
+// SHA-256 backends
+#define SHA256_SOFTWARE 1
+#define SHA256_MBEDTLS 2
+#define SHA256_SECURE_ELEMENT 3
+
+#ifndef SHA256_BACKEND
+#define SHA256_BACKEND SHA256_MBEDTLS
+#endif
+
+#if SHA256_BACKEND == SHA256_SECURE_ELEMENT && !defined(HARDWARE_CRYPTO)
+#error "SHA256_SECURE_ELEMENT requires HARDWARE_CRYPTO"
+#endif
+
+#if SHA256_BACKEND == SHA256_SOFTWARE
+#include <SHA256.h>
+#elif SHA256_BACKEND == SHA256_MBEDTLS
+#include <mbedtls/sha256.h>
+#endif
+
 namespace Crypto
 {
     bool init();
     bool isConfigured();
     void configure();
 
+    /**
+     * Keeps the secure element awake while one CTAP transaction is processed, so its commands are issued back
+     * to back instead of waking it up for every primitive. Sessions nest, the outermost one puts the chip back
+     * to idle. The chip is woken up with the first command, and again when its watchdog has put it to sleep
+     * while waiting for the user.
+     * Without the secure element the session does nothing.
+     */
+    class Session
+    {
+    public:
+        struct Stats
+        {
+            uint16_t commands;
+            uint16_t wakeUps;
+            // time spent in the commands, including the I2C transfers
+            int64_t busy;
+            int64_t duration;
+        };
+
+    public:
+        Session();
+        ~Session();
+
+        Session(const Session &) = delete;
+        Session &operator=(const Session &) = delete;
+
+        // statistics of the last outermost session
+        static const Stats &getStats();
+    };
+
     namespace SHA256
     {
+        // computed by the backend selected with SHA256_BACKEND
         bool hash(const uint8_t *data, const size_t length, uint8_t *sha);
-    }
+
+        bool hashSoftware(const uint8_t *data, const size_t length, uint8_t *sha);
+        bool hashMbedTLS(const uint8_t *data, const size_t length, uint8_t *sha);
+#if defined(HARDWARE_CRYPTO)
+        bool hashSecureElement(const uint8_t *data, const size_t length, uint8_t *sha);
+#endif
+
+        /**
+         * Hash of data passed in any number of pieces, computed by the backend selected with SHA256_BACKEND.
+         * The secure element has a single SHA engine and collects the pieces, only one of its hashes can be
+         * computed at a time.
+         */
+        class Context
+        {
+        public:
+            void init();
+            void update(const uint8_t *data, const size_t length);
+            bool finalize(uint8_t *sha);
+
+        protected:
+#if SHA256_BACKEND == SHA256_SOFTWARE
+            ::SHA256 sha256;
+#elif SHA256_BACKEND == SHA256_MBEDTLS
+            mbedtls_sha256_context sha256;
+#else
+            size_t length;
+            bool overflow;
+#endif
+        };
+    } // namespace SHA256
 
     namespace ECDSA
     {
@@ -35,7 +114,13 @@ namespace Crypto
 
         void encodeSignature(const uint8_t *signature, uint8_t *encodedSignature, size_t *encodedSize);
 
+        // random private key of a new credential
+        void generatePrivateKey(PrivateKey *privateKey);
+
+        // the public key and the signature are computed with a precomputed table of multiples of the generator
         void derivePublicKey(const PrivateKey *privateKey, PublicKey *publicKey);
 
+        bool sign(const PrivateKey *privateKey, const uint8_t *hash, uint8_t *signature);
+
     } // namespace ECDSA
 } // namespace Crypto
\ No newline at end of file
@@ -1,11 +1,11 @@
 #pragma once
 
-#include <memory>
-
 #include "crypto/crypto.h"
 
 #include "fido2/ctap/ctap.h"
 #include "fido2/uuid.h"
+#include "util/arena.h"
+#include "util/cancellation.h"
 
 namespace FIDO2
 {
@@ -41,15 +41,28 @@ namespace FIDO2
         uint8_t getStatus();
         void setStatus(Status status);
 
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Command *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
+        // the response is created in the arena the request was parsed into
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Command *request, Arena &arena, FIDO2::CTAP::Command **response, const CancellationToken &token);
+
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetInfo *request, Arena &arena, FIDO2::CTAP::Command **response);
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetAssertion *request, Arena &arena, FIDO2::CTAP::Command **response);
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::MakeCredential *request, Arena &arena, FIDO2::CTAP::Command **response, const CancellationToken &token);
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::ClientPIN *request, Arena &arena, FIDO2::CTAP::Command **response);
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::Reset *request, Arena &arena, FIDO2::CTAP::Command **response);
+
+        // signed with the given credential key, or with the attestation key when it is null
+        FIDO2::CTAP::Status sign(const FIDO2::CTAP::AuthenticatorData *authenticatorData, const uint8_t *clientDataHash, const Crypto::ECDSA::PrivateKey *privateKey, uint8_t *signature, size_t *signatureSize);
 
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetInfo *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetAssertion *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::MakeCredential *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::ClientPIN *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::Reset *request, std::unique_ptr<FIDO2::CTAP::Command> &response);
+        /**
+         * Credential keys are not stored, the credential ID carries the key encrypted and authenticated under
+         * the device master key, bound to the RP ID hash
+         */
+        void loadMasterKey();
+        void resetMasterKey();
 
-        void sign(const FIDO2::CTAP::AuthenticatorData *authenticatorData, const uint8_t *clientDataHash, uint8_t *signature, size_t *signatureSize);
+        void wrapKey(const uint8_t *rpIdHash, const Crypto::ECDSA::PrivateKey *privateKey, uint8_t *credentialId);
+        // false when the ID was not created by this authenticator for the RP
+        bool unwrapKey(const uint8_t *rpIdHash, const ByteView &credentialId, Crypto::ECDSA::PrivateKey *privateKey);
 
     } // namespace Authenticator
 } // namespace FIDO2
\ No newline at end of file
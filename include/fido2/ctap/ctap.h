@@ -1,15 +1,15 @@
 #pragma once
 
-#include <exception>
-#include <memory>
 #include <vector>
 
-#include <YACL.h>
-
 #include "config.h"
 #include "crypto/crypto.h"
+#include "fido2/ctap/decoder.h"
+#include "fido2/ctap/encoder.h"
+#include "fido2/ctap/status.h"
 #include "fido2/uuid.h"
 #include "util/be.h"
+#include "util/arena.h"
 #include "util/fixedbuffer.h"
 
 namespace FIDO2
@@ -32,80 +32,6 @@ namespace FIDO2
             authenticatorVendorLast = 0xBF,
         };
 
-        enum Status
-        {
-            CTAP2_OK = 0x00,                        // Indicates successful response.
-            CTAP1_ERR_INVALID_COMMAND = 0x01,       // The command is not a valid CTAP command.
-            CTAP1_ERR_INVALID_PARAMETER = 0x02,     // The command included an invalid parameter.
-            CTAP1_ERR_INVALID_LENGTH = 0x03,        // Invalid message or item length.
-            CTAP1_ERR_INVALID_SEQ = 0x04,           // Invalid message sequencing.
-            CTAP1_ERR_TIMEOUT = 0x05,               // Message timed out.
-            CTAP1_ERR_CHANNEL_BUSY = 0x06,          // Channel busy. Client SHOULD retry the request after a short delay. Note that the client may abort the transaction if the command is no longer relevant.
-            CTAP1_ERR_LOCK_REQUIRED = 0x0A,         // Command requires channel lock.
-            CTAP1_ERR_INVALID_CHANNEL = 0x0B,       // Command not allowed on this cid.
-            CTAP2_ERR_CBOR_UNEXPECTED_TYPE = 0x11,  // Invalid/unexpected CBOR error.
-            CTAP2_ERR_INVALID_CBOR = 0x12,          // Error when parsing CBOR.
-            CTAP2_ERR_MISSING_PARAMETER = 0x14,     // Missing non-optional parameter.
-            CTAP2_ERR_LIMIT_EXCEEDED = 0x15,        // Limit for number of items exceeded.
-            CTAP2_ERR_UNSUPPORTED_EXTENSION = 0x16, // Unsupported extension.
-            CTAP2_ERR_CREDENTIAL_EXCLUDED = 0x19,   // Valid credential found in the exclude list.
-            CTAP2_ERR_PROCESSING = 0x21,            // Processing (Lengthy operation is in progress).
-            CTAP2_ERR_INVALID_CREDENTIAL = 0x22,    // Credential not valid for the authenticator.
-            CTAP2_ERR_USER_ACTION_PENDING = 0x23,   // Authentication is waiting for user interaction.
-            CTAP2_ERR_OPERATION_PENDING = 0x24,     // Processing, lengthy operation is in progress.
-            CTAP2_ERR_NO_OPERATIONS = 0x25,         // No request is pending.
-            CTAP2_ERR_UNSUPPORTED_ALGORITHM = 0x26, // Authenticator does not support requested algorithm.
-            CTAP2_ERR_OPERATION_DENIED = 0x27,      // Not authorized for requested operation.
-            CTAP2_ERR_KEY_STORE_FULL = 0x28,        // Internal key storage is full.
-            CTAP2_ERR_NO_OPERATION_PENDING = 0x2A,  // No outstanding operations.
-            CTAP2_ERR_UNSUPPORTED_OPTION = 0x2B,    // Unsupported option.
-            CTAP2_ERR_INVALID_OPTION = 0x2C,        // Not a valid option for current operation.
-            CTAP2_ERR_KEEPALIVE_CANCEL = 0x2D,      // Pending keep alive was cancelled.
-            CTAP2_ERR_NO_CREDENTIALS = 0x2E,        // No valid credentials provided.
-            CTAP2_ERR_USER_ACTION_TIMEOUT = 0x2F,   // Timeout waiting for user interaction.
-            CTAP2_ERR_NOT_ALLOWED = 0x30,           // Continuation command, such as, authenticatorGetNextAssertion not allowed.
-            CTAP2_ERR_PIN_INVALID = 0x31,           // PIN Invalid.
-            CTAP2_ERR_PIN_BLOCKED = 0x32,           // PIN Blocked.
-            CTAP2_ERR_PIN_AUTH_INVALID = 0x33,      // PIN authentication,pinUvAuthParam, verification failed.
-            CTAP2_ERR_PIN_AUTH_BLOCKED = 0x34,      // PIN authentication,pinUvAuthParam, blocked. Requires power recycle to reset.
-            CTAP2_ERR_PIN_NOT_SET = 0x35,           // No PIN has been set.
-            CTAP2_ERR_PIN_REQUIRED = 0x36,          // PIN is required for the selected operation.
-            CTAP2_ERR_PIN_POLICY_VIOLATION = 0x37,  // PIN policy violation. Currently only enforces minimum length.
-            CTAP2_ERR_PIN_TOKEN_EXPIRED = 0x38,     // pinUvAuthToken expired on authenticator.
-            CTAP2_ERR_REQUEST_TOO_LARGE = 0x39,     // Authenticator cannot handle this request due to memory constraints.
-            CTAP2_ERR_ACTION_TIMEOUT = 0x3A,        // The current operation has timed out.
-            CTAP2_ERR_UP_REQUIRED = 0x3B,           // User presence is required for the requested operation.
-            CTAP2_ERR_UV_BLOCKED = 0x3C,            // Built in UV is blocked.
-            CTAP1_ERR_OTHER = 0x7F,                 // Other unspecified error.
-            CTAP2_ERR_SPEC_LAST = 0xDF,             // CTAP 2 spec last error.
-            CTAP2_ERR_EXTENSION_FIRST = 0xE0,       // Extension specific error.
-            CTAP2_ERR_EXTENSION_LAST = 0xEF,        // Extension specific error.
-            CTAP2_ERR_VENDOR_FIRST = 0xF0,          // Vendor specific error.
-            CTAP2_ERR_VENDOR_LAST = 0xFF,           // Vendor specific error.
-        };
-
-        class Exception : public std::exception
-        {
-        public:
-            Exception()
-            {
-                this->status = CTAP1_ERR_OTHER;
-            }
-
-            Exception(const Status status)
-            {
-                this->status = status;
-            }
-
-            const Status getStatus() const
-            {
-                return this->status;
-            }
-
-        private:
-            Status status;
-        };
-
 #pragma pack(push, 1)
         union AuthenticatorDataFlags
         {
@@ -138,31 +64,45 @@ namespace FIDO2
         };
 #pragma pack(pop)
 
+        /**
+         * The request structures hold views into the command buffer, they are valid while the request is processed
+         */
         struct PublicKeyCredentialRpEntity
         {
-            String id;
-            String name;
-            String icon;
+            StringView id;
+            StringView name;
+            StringView icon;
         };
 
         struct PublicKeyCredentialUserEntity
         {
-            FixedBuffer64 id;
-            String name;
-            String displayName;
-            String icon;
+            ByteView id;
+            StringView name;
+            StringView displayName;
+            StringView icon;
         };
 
         struct PublicKeyCredentialDescriptor
         {
-            String type;
-            FixedBuffer<CREDENTIAL_ID_LENGTH> credentialId;
-            std::vector<String> transports;
+            StringView type;
+            ByteView credentialId;
         };
 
+        struct PublicKeyCredentialParameters
+        {
+            StringView type;
+            int32_t alg;
+        };
+
+        // decode the elements of the lazily parsed lists
+        Status decode(Decoder &decoder, PublicKeyCredentialDescriptor *descriptor);
+        Status decode(Decoder &decoder, PublicKeyCredentialParameters *parameters);
+
         class Command
         {
         public:
+            virtual ~Command() {}
+
             virtual CommandCode getCommandCode() const = 0;
         };
 
@@ -192,9 +132,9 @@ namespace FIDO2
                 virtual CommandCode getCommandCode() const;
 
             public:
-                String rpId;
+                StringView rpId;
                 uint8_t clientDataHash[32];
-                std::vector<std::unique_ptr<PublicKeyCredentialDescriptor>> allowList;
+                ArrayView<PublicKeyCredentialDescriptor> allowList;
             };
 
             class MakeCredential : public Command
@@ -221,7 +161,7 @@ namespace FIDO2
                 };
 
             public:
-                MakeCredential()
+                MakeCredential() : pinUvAuthProtocol(0)
                 {
                     options.rk = false;
                     options.uv = false;
@@ -234,10 +174,10 @@ namespace FIDO2
                 uint8_t clientDataHash[32];
                 PublicKeyCredentialRpEntity rp;
                 PublicKeyCredentialUserEntity user;
-                std::vector<int8_t> algorithms;
-                std::unique_ptr<FixedBuffer16> pinUvAuthParam;
+                ArrayView<PublicKeyCredentialParameters> pubKeyCredParams;
+                ByteView pinUvAuthParam;
                 uint8_t pinUvAuthProtocol;
-                std::vector<PublicKeyCredentialDescriptor> excludeList;
+                ArrayView<PublicKeyCredentialDescriptor> excludeList;
                 Options options;
             };
 
@@ -283,24 +223,28 @@ namespace FIDO2
                 virtual CommandCode getCommandCode() const;
             };
 
-            Status parse(const uint8_t *data, const size_t length, std::unique_ptr<Command> &request);
+            // the request is created in the arena and is valid until the arena is reset
+            Status parse(const uint8_t *data, const size_t length, Arena &arena, Command **request);
 
-            Status parseGetInfo(const CBOR &cbor, std::unique_ptr<Command> &request);
-            Status parseGetAssertion(const CBOR &cbor, std::unique_ptr<Command> &request);
-            Status parseMakeCredential(const CBOR &cbor, std::unique_ptr<Command> &request);
-            Status parseClientPIN(const CBOR &cbor, std::unique_ptr<Command> &request);
-            Status parseReset(const CBOR &cbor, std::unique_ptr<Command> &request);
+            Status parseGetInfo(Decoder &decoder, Arena &arena, Command **request);
+            Status parseGetAssertion(Decoder &decoder, Arena &arena, Command **request);
+            Status parseMakeCredential(Decoder &decoder, Arena &arena, Command **request);
+            Status parseClientPIN(Decoder &decoder, Arena &arena, Command **request);
+            Status parseReset(Decoder &decoder, Arena &arena, Command **request);
 
             // parse data structures
-            Status parseRpEntity(const CBOR &cbor, PublicKeyCredentialRpEntity *rp);
-            Status parseUserEntity(const CBOR &cbor, PublicKeyCredentialUserEntity *user);
-            Status parsePublicKey(const CBOR &cbor, Crypto::ECDSA::PublicKey *publicKey);
+            Status parseRpEntity(Decoder &decoder, PublicKeyCredentialRpEntity *rp);
+            Status parseUserEntity(Decoder &decoder, PublicKeyCredentialUserEntity *user);
+            Status parsePublicKey(Decoder &decoder, Crypto::ECDSA::PublicKey *publicKey);
 
         }; // namespace Request
 
         namespace Response
         {
-            class GetInfo : public Command
+            /**
+             * Description of the authenticator, encoded once into the authenticatorGetInfo response
+             */
+            class Info
             {
             public:
                 struct Options
@@ -316,22 +260,33 @@ namespace FIDO2
                     bool config : 1;
                 };
 
-            public:
-                virtual CommandCode getCommandCode() const;
-
             public:
                 std::vector<String> versions;
                 std::vector<String> extensions;
                 FIDO2::UUID aaguid;
                 Options options;
-                std::unique_ptr<uint16_t> maxMsgSize;
-                std::unique_ptr<std::vector<uint8_t>> pinUvAuthProtocols;
-                std::unique_ptr<uint8_t> maxCredentialCountInList;
-                std::unique_ptr<uint8_t> maxCredentialIdLength;
-                std::unique_ptr<std::vector<String>> transports;
-                // std::unique_ptr<std::vector<> algorithms;
-                std::unique_ptr<uint8_t> maxAuthenticatorConfigLength;
-                std::unique_ptr<uint8_t> defaultCredProtect;
+                // optional values are not encoded when they are 0 or empty
+                uint16_t maxMsgSize = 0;
+                std::vector<uint8_t> pinUvAuthProtocols;
+                uint8_t maxCredentialCountInList = 0;
+                uint8_t maxCredentialIdLength = 0;
+                std::vector<String> transports;
+                // std::vector<> algorithms;
+                uint8_t maxAuthenticatorConfigLength = 0;
+                uint8_t defaultCredProtect = 0;
+            };
+
+            class GetInfo : public Command
+            {
+            public:
+                virtual CommandCode getCommandCode() const;
+
+            public:
+                // parameters encoded by encodeInfo, sent as they are except for the clientPin option
+                ByteView encoded;
+                // position of the clientPin option value in the encoding, 0 when the option is not present
+                size_t clientPinPosition;
+                bool clientPin;
             };
 
             class GetAssertion : public Command
@@ -363,14 +318,28 @@ namespace FIDO2
             class ClientPIN : public Command
             {
             public:
+                // parameters included in the response
+                struct Present
+                {
+                    bool publicKey : 1;
+                    bool pinUvAuthToken : 1;
+                    bool pinRetries : 1;
+                    bool powerCycleState : 1;
+                    bool uvRetries : 1;
+                };
+
+            public:
+                ClientPIN() : present() {}
+
                 virtual CommandCode getCommandCode() const;
 
             public:
-                std::unique_ptr<Crypto::ECDSA::PublicKey> publicKey;
-                std::unique_ptr<FixedBuffer16> pinUvAuthToken;
-                std::unique_ptr<uint8_t> pinRetries;
-                std::unique_ptr<bool> powerCycleState;
-                std::unique_ptr<uint8_t> uvRetries;
+                Present present;
+                Crypto::ECDSA::PublicKey publicKey;
+                FixedBuffer16 pinUvAuthToken;
+                uint8_t pinRetries;
+                bool powerCycleState;
+                uint8_t uvRetries;
             };
 
             class Reset : public Command
@@ -379,14 +348,16 @@ namespace FIDO2
                 virtual CommandCode getCommandCode() const;
             };
 
-            // encode the response
-            Status encode(const Command *response, std::unique_ptr<CBOR> &cbor);
+            // encode the response parameters, nothing is written when the response has none
+            Status encode(const Command *response, Encoder &encoder);
+
+            Status encode(const Response::GetInfo *response, Encoder &encoder);
+            Status encode(const Response::GetAssertion *response, Encoder &encoder);
+            Status encode(const Response::MakeCredential *response, Encoder &encoder);
+            Status encode(const Response::ClientPIN *response, Encoder &encoder);
+            Status encode(const Response::Reset *response, Encoder &encoder);
 
-            Status encode(const Response::GetInfo *response, std::unique_ptr<CBOR> &cbor);
-            Status encode(const Response::GetAssertion *response, std::unique_ptr<CBOR> &cbor);
-            Status encode(const Response::MakeCredential *response, std::unique_ptr<CBOR> &cbor);
-            Status encode(const Response::ClientPIN *response, std::unique_ptr<CBOR> &cbor);
-            Status encode(const Response::Reset *response, std::unique_ptr<CBOR> &cbor);
+            Status encodeInfo(const Response::Info *info, Encoder &encoder, size_t *clientPinPosition);
 
             void encodePublicKey(Crypto::ECDSA::PublicKey *publicKey, uint8_t *encodedKey);
 
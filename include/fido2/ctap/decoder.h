@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "fido2/ctap/status.h"
+#include "util/view.h"
+
+#ifndef FIDO2_CBOR_MAX_DEPTH
+#define FIDO2_CBOR_MAX_DEPTH 4
+#endif
+
+#ifndef FIDO2_CBOR_MAX_ARRAY_LENGTH
+#define FIDO2_CBOR_MAX_ARRAY_LENGTH 64
+#endif
+
+#ifndef FIDO2_CBOR_MAX_MAP_SIZE
+#define FIDO2_CBOR_MAX_MAP_SIZE 16
+#endif
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        /**
+         * Forward only CBOR decoder reading the items directly from the request buffer.
+         *
+         * Maps are walked once from the start to the end, the caller dispatches on every key as it is read
+         * and skips the values it is not interested in. Only definite length items are accepted, as
+         * required by the CTAP2 canonical CBOR encoding.
+         *
+         * The decoder keeps track of the containers it is in, so the nesting depth, the array lengths and
+         * the map sizes are limited as every item is read, before the caller interprets it.
+         */
+        class Decoder
+        {
+        public:
+            enum MajorType
+            {
+                TYPE_UNSIGNED = 0,
+                TYPE_NEGATIVE = 1,
+                TYPE_BYTES = 2,
+                TYPE_TEXT = 3,
+                TYPE_ARRAY = 4,
+                TYPE_MAP = 5,
+                TYPE_TAG = 6,
+                TYPE_SIMPLE = 7,
+            };
+
+        public:
+            Decoder(const uint8_t *data, const size_t length);
+
+            bool atEnd() const;
+            size_t getPosition() const;
+
+            // encoded items between the given position and the current one
+            ByteView slice(const size_t from) const;
+
+            Status peekType(MajorType &type) const;
+            // type and argument of the next item, the argument is the length of strings, arrays and maps
+            Status peekHeader(MajorType &type, uint64_t &argument) const;
+
+            Status readInt(int32_t &value);
+            Status readBool(bool &value);
+            Status readBytes(ByteView &value);
+            Status readText(StringView &value);
+            Status readArray(size_t &count);
+            Status readMap(size_t &count);
+
+            // skip the next item including all the nested items
+            Status skip();
+
+        protected:
+            Status readHeader(uint8_t &type, uint64_t &value);
+            Status track(const uint8_t type, const uint64_t argument);
+
+        protected:
+            const uint8_t *data;
+            size_t length;
+            size_t position;
+            // number of items left in every container being read, innermost last
+            uint32_t remaining[FIDO2_CBOR_MAX_DEPTH];
+            uint8_t depth;
+        };
+
+        /**
+         * CBOR array decoded on demand.
+         * The parser validates every element once and keeps only the location of the encoded elements,
+         * the elements are decoded again one at a time while they are iterated.
+         */
+        template <typename T>
+        class ArrayView
+        {
+        public:
+            class Reader
+            {
+            public:
+                Reader(const ArrayView<T> &view) : decoder(view.elements.data, view.elements.length), remaining(view.count)
+                {
+                }
+
+                bool next(T &item)
+                {
+                    if (remaining == 0)
+                    {
+                        return false;
+                    }
+                    remaining--;
+
+                    return decode(decoder, &item) == CTAP2_OK;
+                }
+
+            protected:
+                Decoder decoder;
+                size_t remaining;
+            };
+
+        public:
+            bool isPresent() const
+            {
+                return elements.isPresent();
+            }
+
+            size_t size() const
+            {
+                return count;
+            }
+
+            Reader read() const
+            {
+                return Reader(*this);
+            }
+
+            Status parse(Decoder &decoder)
+            {
+                Status status = decoder.readArray(count);
+                if (status != CTAP2_OK)
+                {
+                    return status;
+                }
+
+                const size_t start = decoder.getPosition();
+                for (size_t i = 0; i < count; i++)
+                {
+                    T item;
+                    status = decode(decoder, &item);
+                    if (status != CTAP2_OK)
+                    {
+                        return status;
+                    }
+                }
+
+                elements = decoder.slice(start);
+
+                return CTAP2_OK;
+            }
+
+        protected:
+            ByteView elements;
+            size_t count = 0;
+        };
+    } // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "fido2/ctap/status.h"
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        /**
+         * CBOR encoder writing the items directly into the response buffer.
+         *
+         * The number of entries of maps and arrays is written up front, the caller writes the entries in the
+         * CTAP2 canonical order. Every write is checked against the size of the buffer.
+         */
+        class Encoder
+        {
+        public:
+            Encoder(uint8_t *data, const size_t maxLength);
+
+            size_t getLength() const;
+
+            Status writeInt(const int32_t value);
+            Status writeBool(const bool value);
+            Status writeBytes(const uint8_t *value, const size_t length);
+            Status writeText(const char *value);
+            Status writeArray(const size_t count);
+            Status writeMap(const size_t count);
+
+            // header of a byte string whose content is written with writeRaw
+            Status writeBytesHeader(const size_t length);
+            Status writeRaw(const uint8_t *value, const size_t length);
+
+        protected:
+            Status writeHeader(const uint8_t type, const uint32_t argument);
+
+        protected:
+            uint8_t *data;
+            size_t maxLength;
+            size_t position;
+        };
+    } // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
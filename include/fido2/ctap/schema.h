@@ -0,0 +1,188 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "fido2/ctap/decoder.h"
+#include "fido2/ctap/status.h"
+#include "util/util.h"
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        namespace Request
+        {
+            /**
+             * Description of one entry of the parameters map of a command.
+             * The type and the length are validated before the value is read into the request.
+             */
+            template <typename T>
+            struct Field
+            {
+                int32_t key;
+                Decoder::MajorType type;
+                bool required;
+                // maximum length of byte and text strings, number of array elements or map entries, or
+                // maximum value of unsigned integers, 0 for no limit
+                uint32_t maxLength;
+                Status (*read)(Decoder &decoder, T *request);
+            };
+
+            /**
+             * Parameters map of a command, specialised for every request with a constexpr array of fields:
+             *
+             *     template <>
+             *     struct Schema<MakeCredential>
+             *     {
+             *         static constexpr Field<MakeCredential> fields[] = {...};
+             *     };
+             */
+            template <typename T>
+            struct Schema;
+
+            template <typename T>
+            constexpr uint32_t requiredKeys(const Field<T> *fields, const size_t count)
+            {
+                return count == 0 ? 0 : (fields->required ? 1UL << fields->key : 0) | requiredKeys(fields + 1, count - 1);
+            }
+
+            template <typename T>
+            constexpr bool containsKey(const Field<T> *fields, const size_t count, const int32_t key)
+            {
+                return count > 0 && (fields->key == key || containsKey(fields + 1, count - 1, key));
+            }
+
+            // keys are used as bit positions and have to be unique
+            template <typename T>
+            constexpr bool validKeys(const Field<T> *fields, const size_t count)
+            {
+                return count == 0 || (fields->key >= 0 && fields->key < 32 &&
+                                      !containsKey(fields + 1, count - 1, fields->key) &&
+                                      validKeys(fields + 1, count - 1));
+            }
+
+            // check the header of the next item against the description of a field
+            Status validateField(const Decoder &decoder, const Decoder::MajorType type, const uint32_t maxLength);
+
+            /**
+             * Decode the parameters map of a command as described by its schema.
+             * Unknown keys are skipped, duplicate keys and missing required keys are rejected.
+             */
+            template <typename T>
+            Status decodeMap(Decoder &decoder, T *request)
+            {
+                typedef Schema<T> S;
+                static constexpr size_t count = sizeof(S::fields) / sizeof(S::fields[0]);
+                static constexpr uint32_t required = requiredKeys(S::fields, count);
+                static_assert(validKeys(S::fields, count), "schema keys have to be unique and below 32");
+
+                size_t entries;
+                RETURN_IF_ERROR(decoder.readMap(entries));
+
+                uint32_t present = 0;
+
+                for (size_t i = 0; i < entries; i++)
+                {
+                    int32_t key;
+                    RETURN_IF_ERROR(decoder.readInt(key));
+
+                    const Field<T> *field = nullptr;
+                    for (size_t j = 0; j < count; j++)
+                    {
+                        if (S::fields[j].key == key)
+                        {
+                            field = &S::fields[j];
+                            break;
+                        }
+                    }
+
+                    if (field == nullptr)
+                    {
+                        RETURN_IF_ERROR(decoder.skip());
+                        continue;
+                    }
+
+                    if (present & (1UL << key))
+                    {
+                        RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
+                    }
+                    present |= 1UL << key;
+
+                    RETURN_IF_ERROR(validateField(decoder, field->type, field->maxLength));
+                    RETURN_IF_ERROR(field->read(decoder, request));
+                }
+
+                if ((present & required) != required)
+                {
+                    RETURN_ERROR(CTAP2_ERR_MISSING_PARAMETER);
+                }
+
+                return CTAP2_OK;
+            }
+
+            /**
+             * Readers for the common kinds of fields, instantiated with the member the value is stored in
+             */
+
+            // byte string of exactly the size of the member array
+            template <typename T, size_t N, uint8_t (T::*member)[N]>
+            Status readFixedBytes(Decoder &decoder, T *request)
+            {
+                ByteView value;
+                RETURN_IF_ERROR(decoder.readBytes(value));
+
+                if (value.length != N)
+                {
+                    RETURN_ERROR(CTAP1_ERR_INVALID_LENGTH);
+                }
+
+                memcpy(request->*member, value.data, N);
+
+                return CTAP2_OK;
+            }
+
+            template <typename T, ByteView T::*member>
+            Status readByteView(Decoder &decoder, T *request)
+            {
+                return decoder.readBytes(request->*member);
+            }
+
+            template <typename T, StringView T::*member>
+            Status readStringView(Decoder &decoder, T *request)
+            {
+                return decoder.readText(request->*member);
+            }
+
+            template <typename T, typename V, V T::*member>
+            Status readInteger(Decoder &decoder, T *request)
+            {
+                int32_t value;
+                RETURN_IF_ERROR(decoder.readInt(value));
+
+                request->*member = (V)value;
+
+                return CTAP2_OK;
+            }
+
+            template <typename T, typename V, ArrayView<V> T::*member>
+            Status readArrayView(Decoder &decoder, T *request)
+            {
+                return (request->*member).parse(decoder);
+            }
+
+            // nested structure with its own parser
+            template <typename T, typename V, V T::*member, Status (*parse)(Decoder &, V *)>
+            Status readStruct(Decoder &decoder, T *request)
+            {
+                return parse(decoder, &(request->*member));
+            }
+
+            // validated but not used
+            template <typename T>
+            Status skipValue(Decoder &decoder, T *request)
+            {
+                return decoder.skip();
+            }
+        } // namespace Request
+    }     // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include <Arduino.h>
 
 #include "config.h"
+#include "util/cancellation.h"
+
+// number of requests which can be received while the previous ones are processed
+#define RECEIVE_BUFFER_COUNT 2
 
 namespace FIDO2
 {
@@ -24,17 +28,48 @@ namespace FIDO2
 
                 bool isComplete();
 
+                uint16_t getFragmentCount();
+                uint16_t getFragment(const uint16_t index, const uint16_t maxLength, uint8_t *fragment);
+
                 uint8_t getCmd();
+                void setCmd(uint8_t cmd);
                 uint16_t getPayloadLength();
                 void setPayloadLength(uint16_t length);
                 uint8_t *getPayload();
+                size_t getMaxPayloadLength();
+
+                CancellationToken &getCancellation();
 
             protected:
                 uint8_t buffer[FIDO2_MAX_MSG_SIZE];
                 uint16_t position;
+                uint16_t fragments;
+
+                // set when the client cancels the request held in the buffer
+                CancellationToken cancellation;
+            };
+
+            /**
+             * Receive buffers shared between the BLE callbacks reassembling requests and the worker processing them
+             */
+            class CommandBufferPool
+            {
+            public:
+                CommandBufferPool();
+
+                CommandBuffer *acquire();
+                void release(CommandBuffer *buffer);
+
+            protected:
+                CommandBuffer buffers[RECEIVE_BUFFER_COUNT];
+                bool used[RECEIVE_BUFFER_COUNT];
+                portMUX_TYPE mux;
             };
 
-            extern CommandBuffer commandBuffer;
+            extern CommandBufferPool commandBufferPool;
+
+            // transmit buffer for the responses, used only by the worker
+            extern CommandBuffer responseBuffer;
 
         } // namespace BLE
     }     // namespace Transport
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "fido2/transport/ble/service.h"
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            enum CaptureDirection
+            {
+                CAPTURE_INBOUND = 0,
+                CAPTURE_OUTBOUND = 1,
+            };
+
+            /**
+             * Record a single fragment written to fidoControlPoint or notified on fidoStatus.
+             * Does nothing unless FIDO2_CAPTURE_ENABLED is defined.
+             */
+            void captureRecord(const CaptureDirection direction, const uint8_t *data, const size_t length);
+
+            /**
+             * Print the captured fragments to the serial console, one fragment per line
+             */
+            void captureDump();
+
+            void captureClear();
+
+            /**
+             * Feed the captured inbound fragments through the control point keeping their original spacing
+             */
+            bool captureReplay(ControlPoint *controlPoint);
+
+            /**
+             * Handle capture commands from the serial console, called from the main loop
+             */
+            void captureUpdate();
+
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <BLECharacteristic.h>
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            /**
+             * Sends notifications of the fidoStatus characteristic respecting the congestion state
+             * of the BLE stack and retrying transient failures.
+             */
+            class NotificationSender
+            {
+            public:
+                struct Stats
+                {
+                    uint16_t fragments;
+                    uint16_t retries;
+                    uint16_t failures;
+                    size_t bytes;
+                    int64_t duration;
+                };
+
+            public:
+                void init(BLECharacteristic *characteristic);
+
+                bool begin(const TickType_t timeout = portMAX_DELAY);
+                bool send(const uint8_t *data, const size_t length);
+                // single attempt which never waits, for the BLE stack callbacks and the timer service task
+                bool trySend(const uint8_t *data, const size_t length);
+                const Stats &end();
+
+                void setCongested(const bool congested);
+                bool isCongested();
+                void setNotifyStatus(const BLECharacteristicCallbacks::Status status);
+
+            protected:
+                enum Result
+                {
+                    RESULT_PENDING,
+                    RESULT_SENT,
+                    RESULT_TRANSIENT_ERROR,
+                    RESULT_ERROR,
+                };
+
+                Result notify(const uint8_t *data, const size_t length);
+
+                BLECharacteristic *characteristic;
+                SemaphoreHandle_t mutex;
+                EventGroupHandle_t events;
+                volatile Result result;
+                Stats stats;
+                int64_t startedAt;
+            };
+
+            extern NotificationSender notificationSender;
+
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <BLEDevice.h>
 #include <BLEUUID.h>
 
+#include "fido2/transport/ble/buffer.h"
+
 namespace FIDO2
 {
     namespace Transport
@@ -18,17 +20,29 @@ namespace FIDO2
                 static const uint8_t CMD_CANCEL = 0xbe;
                 static const uint8_t CMD_ERROR = 0xbf;
 
+                static const uint8_t ERR_BUSY = 0x06;
+
             public:
                 static BLEUUID UUID();
 
+                static uint16_t getLength();
+
                 virtual void onWrite(BLECharacteristic *pCharacteristic);
 
-                void processRequest();
+                void ingest(const uint8_t *data, const size_t length);
+
+                void processRequest(CommandBuffer &request);
+
+                void processMessage(CommandBuffer &request, CommandBuffer &response);
 
-                void processMessage();
+            protected:
+                uint16_t sendResponse(CommandBuffer &buffer);
+
+                void sendError(const uint8_t error);
 
             protected:
-                void sendResponse();
+                // buffer the current frame is reassembled into, accessed only from the BLE callbacks
+                CommandBuffer *receiving = nullptr;
             };
 
             class ControlPointLength : public BLECharacteristicCallbacks
@@ -43,6 +57,8 @@ namespace FIDO2
             {
             public:
                 static BLEUUID UUID();
+
+                virtual void onStatus(BLECharacteristic *pCharacteristic, BLECharacteristicCallbacks::Status s, uint32_t code);
             };
 
             class ServiceRevision : public BLECharacteristicCallbacks
@@ -61,13 +77,22 @@ namespace FIDO2
 
                 static void init();
 
+                static ControlPoint *getControlPoint();
+
             protected:
                 static BLEService *fido2Service;
+                static ControlPoint *controlPoint;
             };
 
-            bool keepaliveStart(BLECharacteristic *statusCharacteristic);
+            bool keepaliveInit();
+            void keepaliveStart();
             void keepaliveStop();
 
+            bool workerStart(ControlPoint *controlPoint);
+            bool workerSubmit(CommandBuffer *buffer);
+            bool workerIsBusy();
+            void workerCancel();
+
         } // namespace BLE
     }     // namespace Transport
 } // namespace FIDO2
\ No newline at end of file
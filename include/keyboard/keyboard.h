@@ -1,10 +1,12 @@
 #pragma once
 
+#include "util/cancellation.h"
+
 namespace Keyboard
 {
     void init();
 
     void update();
 
-    bool waitForTouch(const char key, const unsigned long timeout);
+    bool waitForTouch(const char key, const unsigned long timeout, const CancellationToken *token = nullptr);
 };
\ No newline at end of file
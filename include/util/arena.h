@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <new>
+#include <utility>
+
+/**
+ * Bump allocator over a fixed buffer for the objects of one transaction.
+ *
+ * Objects are not freed one by one, reset() releases all of them at once. Destructors are not run,
+ * only objects which do not own any resources may be created in the arena.
+ */
+class Arena
+{
+public:
+    // the buffer has to be aligned for every type created in the arena
+    Arena(uint8_t *buffer, const size_t size);
+
+    // nullptr when the arena is exhausted
+    void *allocate(const size_t size, const size_t alignment);
+
+    template <typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        void *memory = allocate(sizeof(T), alignof(T));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    void reset();
+
+    size_t getUsed() const;
+    // highest usage since start up
+    size_t getPeak() const;
+
+protected:
+    uint8_t *buffer;
+    size_t size;
+    size_t used;
+    size_t peak;
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string.h>
+
 #pragma pack(push, 1)
 template <typename T>
 class BigEndian
@@ -16,11 +18,11 @@ public:
     }
 
     /**
-     * Read BigEndian value from the byte buffer
+     * Read BigEndian value from the byte buffer, which does not need to be aligned
      */
     BigEndian(const uint8_t *val)
     {
-        value = *((const T *)val);
+        memcpy(&value, val, sizeof(T));
     }
 
     BigEndian &operator=(T val)
@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @brief Flag set by the transport when the client cancels the pending request
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() : cancelled(false)
+    {
+    }
+
+    void cancel()
+    {
+        cancelled = true;
+    }
+
+    void reset()
+    {
+        cancelled = false;
+    }
+
+    bool isCancelled() const
+    {
+        return cancelled;
+    }
+
+private:
+    volatile bool cancelled;
+};
\ No newline at end of file
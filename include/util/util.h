@@ -5,14 +5,24 @@
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
-#ifdef DEBUG_EXCEPTIONS
-#define RAISE(exception)                                                                                 \
-    {                                                                                                    \
-        Serial.printf("!> Raised exctption in function %s (%s:%d)\n", __FUNCTION__, __FILE__, __LINE__); \
-        throw exception;                                                                                 \
+#ifdef DEBUG_ERRORS
+#define RETURN_ERROR(status)                                                                                                 \
+    {                                                                                                                        \
+        Serial.printf("!> Returned error 0x%02x in function %s (%s:%d)\n", (int)(status), __FUNCTION__, __FILE__, __LINE__); \
+        return status;                                                                                                       \
     }
 #else
-#define RAISE(exception) throw exception;
+#define RETURN_ERROR(status) return status;
 #endif
 
+// return the status of the expression to the caller unless it is zero, the success value of the status enums
+#define RETURN_IF_ERROR(expression)        \
+    {                                      \
+        const auto _status = (expression); \
+        if (_status != 0)                  \
+        {                                  \
+            return _status;                \
+        }                                  \
+    }
+
 void serialDumpBuffer(const uint8_t *buffer, const size_t len);
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Non-owning view of a byte string, valid as long as the viewed buffer
+ */
+struct ByteView
+{
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+
+    /**
+     * Optional values are present when the view points to a buffer, even an empty one
+     */
+    bool isPresent() const
+    {
+        return data != nullptr;
+    }
+
+    bool equals(const uint8_t *value, const size_t valueLength) const
+    {
+        return length == valueLength && memcmp(data, value, length) == 0;
+    }
+};
+
+/**
+ * Non-owning view of a text string, the text is not null terminated
+ */
+struct StringView
+{
+    const char *data = nullptr;
+    size_t length = 0;
+
+    bool isPresent() const
+    {
+        return data != nullptr;
+    }
+
+    bool equals(const char *str) const;
+    bool equals(const String &str) const;
+
+    /**
+     * Copy the text truncated to the buffer size, the result is always null terminated
+     */
+    size_t copyTo(char *buffer, const size_t size) const;
+
+    void toString(String &str) const;
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <Arduino.h>
+
+#include <algorithm>
+
+#include "config.h"
+#include "benchmark/benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+namespace Benchmark
+{
+    void run()
+    {
+        Serial.println("\n# Benchmarks");
+
+        runTransport();
+        runParser();
+        runEncoder();
+        runCrypto();
+
+        Serial.println("# Benchmarks done\n");
+    }
+
+    /**
+     * @brief Value below which the given percent of the samples fall
+     */
+    uint32_t percentile(std::vector<uint32_t> &samples, const uint8_t percent)
+    {
+        if (samples.empty())
+        {
+            return 0;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        return samples[(samples.size() - 1) * percent / 100];
+    }
+
+    void printLatency(const char *name, std::vector<uint32_t> &samples)
+    {
+        Serial.printf(" * %s: p50 %u us, p90 %u us, p99 %u us\n",
+                      name,
+                      percentile(samples, 50),
+                      percentile(samples, 90),
+                      percentile(samples, 99));
+    }
+} // namespace Benchmark
+
+#else
+
+namespace Benchmark
+{
+    void run() {}
+} // namespace Benchmark
+
+#endif
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include <Arduino.h>
+
+#include "config.h"
+#include "benchmark/benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#include "fido2/ctap/ctap.h"
+
+namespace Benchmark
+{
+    // number of credentials in the excludeList and allowList of the measured requests
+    static const uint8_t listLengths[] = {1, 8, 64};
+
+    /**
+     * Minimal CBOR writer for the benchmark requests
+     */
+    static void writeHeader(std::vector<uint8_t> &out, const uint8_t type, const uint32_t value)
+    {
+        if (value < 24)
+        {
+            out.push_back(type << 5 | value);
+        }
+        else if (value <= 0xff)
+        {
+            out.push_back(type << 5 | 24);
+            out.push_back(value);
+        }
+        else
+        {
+            out.push_back(type << 5 | 25);
+            out.push_back(value >> 8);
+            out.push_back(value & 0xff);
+        }
+    }
+
+    static void writeText(std::vector<uint8_t> &out, const char *text)
+    {
+        const size_t length = strlen(text);
+        writeHeader(out, 3, length);
+        out.insert(out.end(), text, text + length);
+    }
+
+    static void writeBytes(std::vector<uint8_t> &out, const size_t length)
+    {
+        writeHeader(out, 2, length);
+        for (size_t i = 0; i < length; i++)
+        {
+            out.push_back(esp_random() & 0xff);
+        }
+    }
+
+    /**
+     * authenticatorMakeCredential request as sent by a browser, with the given number of excluded credentials
+     */
+    static void buildMakeCredential(std::vector<uint8_t> &out, const uint8_t excludeListLength)
+    {
+        out.clear();
+        out.push_back(FIDO2::CTAP::authenticatorMakeCredential);
+
+        writeHeader(out, 5, 6);
+
+        // clientDataHash
+        writeHeader(out, 0, 1);
+        writeBytes(out, 32);
+
+        // rp
+        writeHeader(out, 0, 2);
+        writeHeader(out, 5, 2);
+        writeText(out, "id");
+        writeText(out, "example.com");
+        writeText(out, "name");
+        writeText(out, "Example");
+
+        // user
+        writeHeader(out, 0, 3);
+        writeHeader(out, 5, 3);
+        writeText(out, "id");
+        writeBytes(out, 16);
+        writeText(out, "name");
+        writeText(out, "user@example.com");
+        writeText(out, "displayName");
+        writeText(out, "User");
+
+        // pubKeyCredParams
+        writeHeader(out, 0, 4);
+        writeHeader(out, 4, 1);
+        writeHeader(out, 5, 2);
+        writeText(out, "alg");
+        writeHeader(out, 1, 6);
+        writeText(out, "type");
+        writeText(out, "public-key");
+
+        // excludeList
+        writeHeader(out, 0, 5);
+        writeHeader(out, 4, excludeListLength);
+        for (uint8_t i = 0; i < excludeListLength; i++)
+        {
+            writeHeader(out, 5, 2);
+            writeText(out, "id");
+            writeBytes(out, CREDENTIAL_ID_LENGTH);
+            writeText(out, "type");
+            writeText(out, "public-key");
+        }
+
+        // options
+        writeHeader(out, 0, 7);
+        writeHeader(out, 5, 1);
+        writeText(out, "rk");
+        out.push_back(0xf4);
+    }
+
+    /**
+     * authenticatorGetAssertion request with the given number of allowed credentials
+     */
+    static void buildGetAssertion(std::vector<uint8_t> &out, const uint8_t allowListLength)
+    {
+        out.clear();
+        out.push_back(FIDO2::CTAP::authenticatorGetAssertion);
+
+        writeHeader(out, 5, 4);
+
+        // rpId
+        writeHeader(out, 0, 1);
+        writeText(out, "example.com");
+
+        // clientDataHash
+        writeHeader(out, 0, 2);
+        writeBytes(out, 32);
+
+        // allowList
+        writeHeader(out, 0, 3);
+        writeHeader(out, 4, allowListLength);
+        for (uint8_t i = 0; i < allowListLength; i++)
+        {
+            writeHeader(out, 5, 2);
+            writeText(out, "id");
+            writeBytes(out, CREDENTIAL_ID_LENGTH);
+            writeText(out, "type");
+            writeText(out, "public-key");
+        }
+
+        // options
+        writeHeader(out, 0, 5);
+        writeHeader(out, 5, 1);
+        writeText(out, "up");
+        out.push_back(0xf5);
+    }
+
+    /**
+     * authenticatorClientPIN request, the subcommands which carry parameters get random values of the expected size
+     */
+    static void buildClientPIN(std::vector<uint8_t> &out, const FIDO2::CTAP::Request::ClientPIN::SubCommand subCommand)
+    {
+        const bool keyAgreement = subCommand == FIDO2::CTAP::Request::ClientPIN::cmdSetPIN ||
+                                  subCommand == FIDO2::CTAP::Request::ClientPIN::cmdChangePIN ||
+                                  subCommand == FIDO2::CTAP::Request::ClientPIN::cmdGetPinUvAuthTokenUsingPin;
+        const bool pinUvAuthParam = subCommand == FIDO2::CTAP::Request::ClientPIN::cmdSetPIN ||
+                                    subCommand == FIDO2::CTAP::Request::ClientPIN::cmdChangePIN;
+        const bool newPinEnc = pinUvAuthParam;
+        const bool pinHashEnc = subCommand == FIDO2::CTAP::Request::ClientPIN::cmdChangePIN ||
+                                subCommand == FIDO2::CTAP::Request::ClientPIN::cmdGetPinUvAuthTokenUsingPin;
+
+        out.clear();
+        out.push_back(FIDO2::CTAP::authenticatorClientPIN);
+
+        writeHeader(out, 5, 2 + keyAgreement + pinUvAuthParam + newPinEnc + pinHashEnc);
+
+        // pinUvAuthProtocol
+        writeHeader(out, 0, 1);
+        writeHeader(out, 0, 1);
+
+        // subCommand
+        writeHeader(out, 0, 2);
+        writeHeader(out, 0, subCommand);
+
+        // keyAgreement, COSE_Key of the platform
+        if (keyAgreement)
+        {
+            writeHeader(out, 0, 3);
+            writeHeader(out, 5, 5);
+            writeHeader(out, 0, 1);
+            writeHeader(out, 0, 2);
+            writeHeader(out, 0, 3);
+            writeHeader(out, 1, 24);
+            writeHeader(out, 1, 0);
+            writeHeader(out, 0, 1);
+            writeHeader(out, 1, 1);
+            writeBytes(out, 32);
+            writeHeader(out, 1, 2);
+            writeBytes(out, 32);
+        }
+
+        if (pinUvAuthParam)
+        {
+            writeHeader(out, 0, 4);
+            writeBytes(out, 16);
+        }
+
+        if (newPinEnc)
+        {
+            writeHeader(out, 0, 5);
+            writeBytes(out, 64);
+        }
+
+        if (pinHashEnc)
+        {
+            writeHeader(out, 0, 6);
+            writeBytes(out, 16);
+        }
+    }
+
+    /**
+     * Requests as sent by browsers and platforms during registration, authentication and PIN setup
+     */
+    void buildCorpus(std::vector<CorpusEntry> &corpus)
+    {
+        CorpusEntry entry;
+
+        for (const uint8_t length : listLengths)
+        {
+            entry.name = "authenticatorMakeCredential, excludeList";
+            entry.parameter = length;
+            buildMakeCredential(entry.request, length);
+            corpus.push_back(entry);
+        }
+
+        for (const uint8_t length : listLengths)
+        {
+            entry.name = "authenticatorGetAssertion, allowList";
+            entry.parameter = length;
+            buildGetAssertion(entry.request, length);
+            corpus.push_back(entry);
+        }
+
+        const FIDO2::CTAP::Request::ClientPIN::SubCommand subCommands[] = {
+            FIDO2::CTAP::Request::ClientPIN::cmdGetPINRetries,
+            FIDO2::CTAP::Request::ClientPIN::cmdGetKeyAgreement,
+            FIDO2::CTAP::Request::ClientPIN::cmdSetPIN,
+            FIDO2::CTAP::Request::ClientPIN::cmdChangePIN,
+            FIDO2::CTAP::Request::ClientPIN::cmdGetPinUvAuthTokenUsingPin,
+        };
+        for (const FIDO2::CTAP::Request::ClientPIN::SubCommand subCommand : subCommands)
+        {
+            entry.name = "authenticatorClientPIN, subCommand";
+            entry.parameter = subCommand;
+            buildClientPIN(entry.request, subCommand);
+            corpus.push_back(entry);
+        }
+    }
+} // namespace Benchmark
+
+#endif
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include "config.h"
+#include "benchmark/benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#include <uECC.h>
+
+#include "crypto/crypto.h"
+#include "fido2/ctap/ctap.h"
+#include "util/util.h"
+
+#define ITERATIONS 20
+
+namespace Benchmark
+{
+    static int randomBytes(uint8_t *dest, unsigned size)
+    {
+        esp_fill_random(dest, size);
+        return 1;
+    }
+
+    static void printSpeedup(std::vector<uint32_t> &baseline, std::vector<uint32_t> &samples)
+    {
+        // median against median, in hundredths
+        const uint32_t speedup = percentile(baseline, 50) * 100 / MAX(percentile(samples, 50), 1);
+        Serial.printf(" * speedup: %u.%02ux\n", speedup / 100, speedup % 100);
+    }
+
+    /**
+     * SHA-256 of the inputs hashed per request on every backend, the results have to match the software backend.
+     * Without the secure element it is compared with a latency model by bench_sha256 of the host build.
+     */
+    static void runHash()
+    {
+        const size_t assertionSize = sizeof(FIDO2::CTAP::AuthenticatorData) - sizeof(FIDO2::CTAP::AttestedCredentialData) + 32;
+        const struct
+        {
+            const char *name;
+            size_t length;
+        } inputs[] = {
+            {"rpId", 11},
+            {"assertion", assertionSize},
+            {"attestation", sizeof(FIDO2::CTAP::AuthenticatorData) + 32},
+        };
+
+        const struct
+        {
+            const char *name;
+            bool (*hash)(const uint8_t *data, const size_t length, uint8_t *sha);
+        } backends[] = {
+            {"software", Crypto::SHA256::hashSoftware},
+            {"mbedtls", Crypto::SHA256::hashMbedTLS},
+#if defined(HARDWARE_CRYPTO)
+            {"secure element", Crypto::SHA256::hashSecureElement},
+#endif
+        };
+
+#if SHA256_BACKEND == SHA256_SECURE_ELEMENT
+        Serial.println("## SHA-256, routed to the secure element");
+#elif SHA256_BACKEND == SHA256_SOFTWARE
+        Serial.println("## SHA-256, routed to software");
+#else
+        Serial.println("## SHA-256, routed to mbedtls");
+#endif
+
+        uint8_t data[sizeof(FIDO2::CTAP::AuthenticatorData) + 32];
+        esp_fill_random(data, sizeof(data));
+
+        std::vector<uint32_t> samples;
+        samples.reserve(ITERATIONS);
+
+        for (auto input : inputs)
+        {
+            Serial.printf("# %s, %u bytes\n", input.name, (unsigned)input.length);
+
+            uint8_t expected[32];
+            Crypto::SHA256::hashSoftware(data, input.length, expected);
+
+            for (auto backend : backends)
+            {
+                uint32_t mismatches = 0;
+
+                samples.clear();
+                for (auto i = 0; i < ITERATIONS; i++)
+                {
+                    uint8_t sha[32];
+                    const int64_t start = esp_timer_get_time();
+                    backend.hash(data, input.length, sha);
+                    samples.push_back(esp_timer_get_time() - start);
+
+                    if (memcmp(sha, expected, sizeof(sha)) != 0)
+                    {
+                        mismatches++;
+                    }
+                }
+
+                printLatency(backend.name, samples);
+                if (mismatches > 0)
+                {
+                    Serial.printf(" * mismatches: %u\n", mismatches);
+                }
+            }
+
+            // the routed backend fed in two pieces, as the signed data is
+            uint32_t mismatches = 0;
+
+            samples.clear();
+            for (auto i = 0; i < ITERATIONS; i++)
+            {
+                const size_t half = input.length / 2;
+                uint8_t sha[32];
+                const int64_t start = esp_timer_get_time();
+                Crypto::SHA256::Context sha256;
+                sha256.init();
+                sha256.update(data, half);
+                sha256.update(data + half, input.length - half);
+                const bool success = sha256.finalize(sha);
+                samples.push_back(esp_timer_get_time() - start);
+
+                if (!success || memcmp(sha, expected, sizeof(sha)) != 0)
+                {
+                    mismatches++;
+                }
+            }
+
+            printLatency("streamed", samples);
+            if (mismatches > 0)
+            {
+                Serial.printf(" * mismatches: %u\n", mismatches);
+            }
+        }
+    }
+
+    /**
+     * P-256 operations with the fixed-base comb against the generic micro-ecc scalar multiplication.
+     * Every public key is compared with the micro-ecc result and every signature is verified with micro-ecc.
+     */
+    void runCrypto()
+    {
+        runHash();
+
+        Serial.println("## P-256");
+
+        // the micro-ecc signatures need a source of randomness
+        uECC_set_rng(randomBytes);
+
+        std::vector<uint32_t> baseline;
+        std::vector<uint32_t> samples;
+        baseline.reserve(ITERATIONS);
+        samples.reserve(ITERATIONS);
+
+        uint32_t mismatches = 0;
+
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            Crypto::ECDSA::PrivateKey privateKey;
+            esp_fill_random(privateKey.key, sizeof(privateKey.key));
+
+            Crypto::ECDSA::PublicKey expected;
+            int64_t start = esp_timer_get_time();
+            uECC_compute_public_key(privateKey.key, (uint8_t *)&expected, Crypto::ECDSA::_es256_curve);
+            baseline.push_back(esp_timer_get_time() - start);
+
+            Crypto::ECDSA::PublicKey publicKey;
+            start = esp_timer_get_time();
+            Crypto::ECDSA::derivePublicKey(&privateKey, &publicKey);
+            samples.push_back(esp_timer_get_time() - start);
+
+            if (memcmp(&expected, &publicKey, sizeof(publicKey)) != 0)
+            {
+                mismatches++;
+            }
+        }
+
+        Serial.println("# public key derivation");
+        printLatency("micro-ecc", baseline);
+        printLatency("comb", samples);
+        printSpeedup(baseline, samples);
+        Serial.printf(" * mismatches: %u\n", mismatches);
+
+        baseline.clear();
+        samples.clear();
+
+        Crypto::ECDSA::PrivateKey privateKey;
+        esp_fill_random(privateKey.key, sizeof(privateKey.key));
+        Crypto::ECDSA::PublicKey publicKey;
+        Crypto::ECDSA::derivePublicKey(&privateKey, &publicKey);
+
+        uint32_t failures = 0;
+
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            uint8_t hash[32];
+            esp_fill_random(hash, sizeof(hash));
+            uint8_t signature[64];
+
+            int64_t start = esp_timer_get_time();
+            uECC_sign(privateKey.key, hash, sizeof(hash), signature, Crypto::ECDSA::_es256_curve);
+            baseline.push_back(esp_timer_get_time() - start);
+
+            start = esp_timer_get_time();
+            const bool success = Crypto::ECDSA::sign(&privateKey, hash, signature);
+            samples.push_back(esp_timer_get_time() - start);
+
+            if (!success || !uECC_verify((const uint8_t *)&publicKey, hash, sizeof(hash), signature, Crypto::ECDSA::_es256_curve))
+            {
+                failures++;
+            }
+        }
+
+        Serial.println("# signature");
+        printLatency("micro-ecc", baseline);
+        printLatency("comb", samples);
+        printSpeedup(baseline, samples);
+        Serial.printf(" * failed: %u\n", failures);
+    }
+} // namespace Benchmark
+
+#endif
\ No newline at end of file
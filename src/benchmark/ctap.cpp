@@ -0,0 +1,219 @@
+#include <Arduino.h>
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+#include "config.h"
+#include "benchmark/benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#include "fido2/authenticator/authenticator.h"
+#include "fido2/ctap/ctap.h"
+#include "util/arena.h"
+#include "util/util.h"
+
+#define ITERATIONS 50
+#define MUTATIONS 300
+#define ARENA_SIZE 1024
+
+namespace Benchmark
+{
+    alignas(8) static uint8_t arenaBuffer[ARENA_SIZE];
+
+    // number of blocks currently allocated on the heap
+    static size_t heapBlocks()
+    {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+
+        return info.allocated_blocks;
+    }
+
+    /**
+     * Error path of the parser, every request of the corpus is truncated at a random position, has random
+     * bytes replaced or a random byte inserted, so the parser stops somewhere in the middle of the request.
+     * A request is accepted only together with a parsed command.
+     */
+    static void runMalformed(const std::vector<CorpusEntry> &corpus)
+    {
+        std::vector<uint8_t> malformed;
+        std::vector<uint32_t> samples;
+        samples.reserve(corpus.size() * MUTATIONS);
+
+        uint32_t rejected = 0;
+        uint32_t inconsistent = 0;
+        int64_t total = 0;
+
+        Arena arena(arenaBuffer, sizeof(arenaBuffer));
+
+        for (const CorpusEntry &entry : corpus)
+        {
+            for (auto i = 0; i < MUTATIONS; i++)
+            {
+                malformed = entry.request;
+                const size_t position = 1 + esp_random() % (malformed.size() - 1);
+                switch (i % 3)
+                {
+                case 0:
+                    malformed.resize(position);
+                    break;
+                case 1:
+                    for (auto j = esp_random() % 4; j < 4; j++)
+                    {
+                        malformed[1 + esp_random() % (malformed.size() - 1)] = esp_random() & 0xff;
+                    }
+                    break;
+                default:
+                    malformed.insert(malformed.begin() + position, esp_random() & 0xff);
+                    break;
+                }
+
+                const int64_t start = esp_timer_get_time();
+                FIDO2::CTAP::Command *command = nullptr;
+                FIDO2::CTAP::Status status = FIDO2::CTAP::Request::parse(malformed.data(), malformed.size(), arena, &command);
+                arena.reset();
+                const int64_t elapsed = esp_timer_get_time() - start;
+                samples.push_back(elapsed);
+                total += elapsed;
+
+                if (status != FIDO2::CTAP::CTAP2_OK)
+                {
+                    rejected++;
+                }
+                if ((status == FIDO2::CTAP::CTAP2_OK) != (command != nullptr))
+                {
+                    inconsistent++;
+                }
+            }
+        }
+
+        Serial.printf("# malformed requests, %u mutations of every request\n", MUTATIONS);
+        printLatency("single pass", samples);
+        Serial.printf(" * throughput: %u requests/s\n", (uint32_t)(samples.size() * 1000000LL / MAX(total, 1)));
+        Serial.printf(" * rejected: %u of %u\n", rejected, samples.size());
+        Serial.printf(" * inconsistent: %u\n", inconsistent);
+    }
+
+    void runParser()
+    {
+        Serial.println("## CTAP request parsing");
+
+        std::vector<CorpusEntry> corpus;
+        buildCorpus(corpus);
+
+        for (const CorpusEntry &entry : corpus)
+        {
+            std::vector<uint32_t> singlePass;
+            singlePass.reserve(ITERATIONS);
+
+            uint32_t failures = 0;
+            size_t allocations = 0;
+            int64_t total = 0;
+
+            Arena arena(arenaBuffer, sizeof(arenaBuffer));
+
+            for (auto i = 0; i < ITERATIONS; i++)
+            {
+                const size_t blocks = heapBlocks();
+
+                const int64_t start = esp_timer_get_time();
+                FIDO2::CTAP::Command *command = nullptr;
+                FIDO2::CTAP::Status status = FIDO2::CTAP::Request::parse(entry.request.data(), entry.request.size(), arena, &command);
+                const int64_t elapsed = esp_timer_get_time() - start;
+                singlePass.push_back(elapsed);
+                total += elapsed;
+
+                // heap blocks held by the parsed request while it is processed
+                allocations = MAX(allocations, heapBlocks() - blocks);
+                arena.reset();
+
+                if (status != FIDO2::CTAP::CTAP2_OK)
+                {
+                    failures++;
+                }
+            }
+
+            Serial.printf("# %s %u, %u bytes\n", entry.name, entry.parameter, entry.request.size());
+            printLatency("single pass", singlePass);
+            Serial.printf(" * throughput: %u requests/s\n", (uint32_t)(ITERATIONS * 1000000LL / MAX(total, 1)));
+            Serial.printf(" * heap allocations per request: %u\n", allocations);
+            Serial.printf(" * arena per request: %u bytes\n", arena.getPeak());
+            Serial.printf(" * failed: %u\n", failures);
+        }
+
+        runMalformed(corpus);
+    }
+
+    void runEncoder()
+    {
+        Serial.println("## CTAP response encoding");
+
+        // attestation response with a full size signature
+        FIDO2::CTAP::Response::MakeCredential response;
+        esp_fill_random(&response.authenticatorData, sizeof(response.authenticatorData));
+        response.authenticatorData.flags.f.attestationData = true;
+        esp_fill_random(response.signature, sizeof(response.signature));
+        response.signatureSize = sizeof(response.signature);
+
+        static uint8_t buffer[FIDO2_MAX_MSG_SIZE];
+
+        std::vector<uint32_t> samples;
+        samples.reserve(ITERATIONS);
+
+        uint32_t failures = 0;
+        uint32_t heap = 0;
+        size_t length = 0;
+
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            const uint32_t freeHeap = ESP.getFreeHeap();
+
+            const int64_t start = esp_timer_get_time();
+            FIDO2::CTAP::Encoder encoder(buffer, sizeof(buffer));
+            FIDO2::CTAP::Status status = FIDO2::CTAP::Response::encode(&response, encoder);
+            samples.push_back(esp_timer_get_time() - start);
+
+            if (status != FIDO2::CTAP::CTAP2_OK)
+            {
+                failures++;
+            }
+
+            heap = MAX(heap, freeHeap - ESP.getFreeHeap());
+            length = encoder.getLength();
+        }
+
+        Serial.printf("# authenticatorMakeCredential attestation, %u bytes\n", length);
+        printLatency("streaming encoder", samples);
+        Serial.printf(" * heap per response: %u bytes\n", heap);
+        Serial.printf(" * failed: %u\n", failures);
+
+        // authenticatorGetInfo, served from the parameters encoded on first use
+        samples.clear();
+
+        Arena arena(arenaBuffer, sizeof(arenaBuffer));
+        FIDO2::CTAP::Request::GetInfo request;
+        FIDO2::CTAP::Command *info = nullptr;
+        failures = FIDO2::Authenticator::processRequest(&request, arena, &info) != FIDO2::CTAP::CTAP2_OK ? ITERATIONS : 0;
+
+        for (auto i = 0; i < ITERATIONS && info != nullptr; i++)
+        {
+            const int64_t start = esp_timer_get_time();
+            FIDO2::CTAP::Encoder encoder(buffer, sizeof(buffer));
+            FIDO2::CTAP::Status status = FIDO2::CTAP::Response::encode(info, encoder);
+            samples.push_back(esp_timer_get_time() - start);
+
+            if (status != FIDO2::CTAP::CTAP2_OK)
+            {
+                failures++;
+            }
+            length = encoder.getLength();
+        }
+
+        Serial.printf("# authenticatorGetInfo, %u bytes\n", length);
+        printLatency("prebuilt", samples);
+        Serial.printf(" * failed: %u\n", failures);
+    }
+} // namespace Benchmark
+
+#endif
\ No newline at end of file
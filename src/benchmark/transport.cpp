@@ -0,0 +1,175 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include "config.h"
+#include "benchmark/benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#include "fido2/transport/ble/buffer.h"
+
+#define ITERATIONS 100
+#define MAX_ATTEMPTS 10
+
+using FIDO2::Transport::BLE::CommandBuffer;
+
+namespace Benchmark
+{
+    // payload sizes of a typical registration and authentication session
+    static const uint16_t transcript[] = {
+        1,    // authenticatorGetInfo request
+        170,  // authenticatorGetInfo response
+        250,  // authenticatorMakeCredential request
+        1080, // authenticatorMakeCredential response with packed attestation
+        130,  // authenticatorGetAssertion request
+        150,  // authenticatorGetAssertion response
+    };
+
+    struct Scenario
+    {
+        uint16_t fragmentSize;
+        // probability in percent for every fragment
+        uint8_t loss;
+        uint8_t reordering;
+    };
+
+    static const Scenario scenarios[] = {
+        {20, 0, 0},
+        {64, 0, 0},
+        {182, 0, 0},
+        {244, 0, 0},
+        {512, 0, 0},
+        {64, 1, 0},
+        {64, 0, 1},
+        {64, 5, 5},
+        {244, 5, 5},
+    };
+
+    static CommandBuffer source;
+    static CommandBuffer target;
+
+    static uint8_t fragment[FIDO2_CONTROL_POINT_MAX_LENGTH];
+    static uint8_t heldFragment[FIDO2_CONTROL_POINT_MAX_LENGTH];
+
+    static bool chance(const uint8_t percent)
+    {
+        return percent > 0 && (esp_random() % 100) < percent;
+    }
+
+    /**
+     * Feed a single fragment to the reassembly buffer the same way the control point does
+     */
+    static bool deliver(const uint8_t *data, const uint16_t length)
+    {
+        if (data[0] & 0x80)
+        {
+            return target.init(data, length) > 0;
+        }
+
+        return target.append(data, length) > 0;
+    }
+
+    /**
+     * Transfer the frame from the source to the target buffer, the whole frame is sent again on failure
+     *
+     * @return number of fragments sent or 0 if the frame could not be transferred
+     */
+    static uint16_t transfer(const Scenario &scenario, uint16_t *attempts)
+    {
+        uint16_t sent = 0;
+
+        for (*attempts = 1; *attempts <= MAX_ATTEMPTS; (*attempts)++)
+        {
+            target.reset();
+
+            bool failed = false;
+            uint16_t size;
+            for (uint16_t index = 0; !failed && (size = source.getFragment(index, scenario.fragmentSize, fragment)) > 0; index++)
+            {
+                sent++;
+
+                if (chance(scenario.loss))
+                {
+                    continue;
+                }
+
+                // swap with the following fragment
+                uint16_t heldSize;
+                if (chance(scenario.reordering) && (heldSize = source.getFragment(index + 1, scenario.fragmentSize, heldFragment)) > 0)
+                {
+                    sent++;
+                    index++;
+
+                    failed = !deliver(heldFragment, heldSize) || !deliver(fragment, size);
+                    continue;
+                }
+
+                failed = !deliver(fragment, size);
+            }
+
+            if (!failed && target.isComplete() && memcmp(source.getBuffer(), target.getBuffer(), source.getBufferLength()) == 0)
+            {
+                return sent;
+            }
+        }
+
+        return 0;
+    }
+
+    void runTransport()
+    {
+        Serial.println("## BLE transport fragmentation and reassembly");
+
+        for (const Scenario &scenario : scenarios)
+        {
+            std::vector<uint32_t> latencies;
+            latencies.reserve(ITERATIONS * sizeof(transcript) / sizeof(transcript[0]));
+
+            uint32_t messages = 0;
+            uint32_t fragments = 0;
+            uint32_t retries = 0;
+            uint32_t failures = 0;
+            uint64_t bytes = 0;
+            uint64_t duration = 0;
+
+            for (auto i = 0; i < ITERATIONS; i++)
+            {
+                for (const uint16_t length : transcript)
+                {
+                    source.reset();
+                    source.setCmd(0x83);
+                    esp_fill_random(source.getPayload(), length);
+                    source.setPayloadLength(length);
+
+                    uint16_t attempts = 0;
+
+                    const int64_t start = esp_timer_get_time();
+                    const uint16_t sent = transfer(scenario, &attempts);
+                    const int64_t elapsed = esp_timer_get_time() - start;
+
+                    messages++;
+                    fragments += sent;
+                    retries += attempts - 1;
+                    if (sent == 0)
+                    {
+                        failures++;
+                        continue;
+                    }
+
+                    bytes += source.getBufferLength();
+                    duration += elapsed;
+                    latencies.push_back(elapsed);
+                }
+            }
+
+            Serial.printf("# fragment %u bytes, loss %u%%, reordering %u%%\n", scenario.fragmentSize, scenario.loss, scenario.reordering);
+            Serial.printf(" * messages: %u, failed: %u, retries: %u\n", messages, failures, retries);
+            Serial.printf(" * fragments per message: %u.%02u\n", fragments / messages, (fragments * 100 / messages) % 100);
+            Serial.printf(" * throughput: %lu KB/s\n", duration > 0 ? (unsigned long)(bytes * 1000000 / duration / 1024) : 0);
+            printLatency("latency", latencies);
+        }
+    }
+} // namespace Benchmark
+
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <Arduino.h>
+
+#include <BLEDevice.h>
+
+#include "ble/connection.h"
+#include "ble/device.h"
+
+// connection interval in units of 1.25 ms
+#define ACTIVE_MIN_INTERVAL 0x06 // 7.5 ms
+#define ACTIVE_MAX_INTERVAL 0x0C // 15 ms
+#define ACTIVE_LATENCY 0
+
+#define IDLE_MIN_INTERVAL 0x50 // 100 ms
+#define IDLE_MAX_INTERVAL 0xA0 // 200 ms
+#define IDLE_LATENCY 4
+
+// supervision timeout in units of 10 ms
+#define SUPERVISION_TIMEOUT 400 // 4 s
+
+// delay before relaxing the parameters, platforms send a few requests in a row
+#define IDLE_DELAY_MS 2000
+
+namespace BLE
+{
+    namespace Connection
+    {
+        static esp_bd_addr_t peerAddress = {};
+        static volatile bool connected = false;
+        static volatile bool active = false;
+
+        static TimerHandle_t xIdleTimer = NULL;
+
+        static void requestParameters(const uint16_t minInterval, const uint16_t maxInterval, const uint16_t latency)
+        {
+            if (!connected)
+            {
+                return;
+            }
+
+            server->updateConnParams(peerAddress, minInterval, maxInterval, latency, SUPERVISION_TIMEOUT);
+        }
+
+        static void idleCallback(TimerHandle_t timer)
+        {
+            active = false;
+
+            requestParameters(IDLE_MIN_INTERVAL, IDLE_MAX_INTERVAL, IDLE_LATENCY);
+        }
+
+        static void gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+        {
+            if (event != ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT)
+            {
+                return;
+            }
+
+            Serial.printf("# Connection parameters: status %d, interval %u.%02u ms, latency %u, timeout %u ms\n",
+                          param->update_conn_params.status,
+                          param->update_conn_params.conn_int * 125 / 100,
+                          param->update_conn_params.conn_int * 125 % 100,
+                          param->update_conn_params.latency,
+                          param->update_conn_params.timeout * 10);
+        }
+
+        void init()
+        {
+            xIdleTimer = xTimerCreate("BLE::Idle", pdMS_TO_TICKS(IDLE_DELAY_MS), pdFALSE, NULL, idleCallback);
+
+            BLEDevice::setCustomGapHandler(gapEventHandler);
+        }
+
+        void onConnect(const esp_bd_addr_t address)
+        {
+            memcpy(peerAddress, address, sizeof(esp_bd_addr_t));
+            connected = true;
+            active = false;
+
+            // keep the parameters chosen by the central for the first requests
+            xTimerReset(xIdleTimer, 0);
+        }
+
+        void onDisconnect()
+        {
+            connected = false;
+            active = false;
+
+            xTimerStop(xIdleTimer, 0);
+        }
+
+        void beginTransaction()
+        {
+            xTimerStop(xIdleTimer, 0);
+
+            if (active)
+            {
+                return;
+            }
+
+            active = true;
+
+            requestParameters(ACTIVE_MIN_INTERVAL, ACTIVE_MAX_INTERVAL, ACTIVE_LATENCY);
+        }
+
+        void endTransaction()
+        {
+            if (!connected)
+            {
+                return;
+            }
+
+            xTimerReset(xIdleTimer, 0);
+        }
+    } // namespace Connection
+} // namespace BLE
\ No newline at end of file
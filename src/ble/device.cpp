@@ -5,6 +5,7 @@
 #include <BLESecurity.h>
 
 #include "config.h"
+#include "ble/connection.h"
 #include "ble/security.h"
 #include "ble/device.h"
 #include "fido2/transport/ble/service.h"
@@ -25,6 +26,9 @@ namespace BLE
         //
         BLEDevice::init(GATT_DEVICE_NAME);
 
+        // allow the central to negotiate an MTU fitting the largest control point length
+        BLEDevice::setMTU(FIDO2_CONTROL_POINT_MAX_LENGTH + 3);
+
         BLEDevice::setEncryptionLevel(ESP_BLE_SEC_ENCRYPT_MITM);
         BLEDevice::setSecurityCallbacks(new Security());
 
@@ -32,6 +36,8 @@ namespace BLE
         server = BLEDevice::createServer();
         server->setCallbacks(new Server());
 
+        Connection::init();
+
         // Device Info Service
         pDeviceInfoService = server->createService((uint16_t)ESP_GATT_UUID_DEVICE_INFO_SVC);
 
@@ -74,10 +80,17 @@ namespace BLE
         BLEDevice::stopAdvertising();
     }
 
+    void Server::onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param)
+    {
+        Connection::onConnect(param->connect.remote_bda);
+    }
+
     void Server::onDisconnect(BLEServer *pServer) {
         Display::disableIcon(ICON_BLUETOOTH);
         Display::showLogo();
 
+        Connection::onDisconnect();
+
         BLEDevice::startAdvertising();
     }
 
@@ -14,11 +14,11 @@ namespace CredentialsStorage
         credentials.clear();
     }
 
-    bool getCredential(const FixedBuffer32 &credentialId, Credential **credential)
+    bool findCredential(const String &rpId, Credential **credential)
     {
         for (auto it = credentials.begin(); it != credentials.end(); it++)
         {
-            if ((*it)->id == credentialId)
+            if ((*it)->rpId == rpId)
             {
                 *credential = (*it).get();
                 return true;
@@ -42,16 +42,15 @@ namespace CredentialsStorage
 
     bool createCredential(const String &rpId, const FixedBuffer64 &userId, Credential **credential)
     {
-        std::unique_ptr<Credential> newCredential;
+        std::unique_ptr<Credential> newCredential(new Credential());
 
-        esp_fill_random(newCredential->id.value, newCredential->id.maxLength);
         newCredential->rpId = rpId;
         newCredential->userId = userId;
 
-        credentials.push_back(std::unique_ptr<Credential>(newCredential.release()));
-
         *credential = newCredential.get();
 
+        credentials.push_back(std::move(newCredential));
+
         return true;
     }
 } // namespace CredentialsStorage
\ No newline at end of file
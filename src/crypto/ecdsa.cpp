@@ -11,11 +11,6 @@ namespace Crypto
     {
         const struct uECC_Curve_t *_es256_curve = uECC_secp256r1();
 
-        void derivePublicKey(const PrivateKey *privateKey, PublicKey *publicKey)
-        {
-            uECC_compute_public_key(privateKey->key, (uint8_t *)publicKey, _es256_curve);
-        }
-
         void encodeSignature(const uint8_t *signature, uint8_t *encodedSignature, size_t *encodedSize)
         {
             memset(encodedSignature, 0, 72);
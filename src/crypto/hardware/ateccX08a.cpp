@@ -1,5 +1,7 @@
 #include <Arduino.h>
 
+#include <esp_timer.h>
+
 #include <SparkFun_ATECCX08a_Arduino_Library.h>
 
 #include "config.h"
@@ -9,10 +11,83 @@
 
 #if defined(HARDWARE_CRYPTO)
 
+// longest data hashed by the secure element in pieces
+#define SHA_BUFFER_SIZE 512
+
+// the watchdog puts the chip to sleep 1.3 s after the wake up, it is woken up again a bit earlier
+#define WATCHDOG_MARGIN 1000000
+
 namespace Crypto
 {
     ATECCX08A atecc;
 
+    static uint8_t sessionDepth = 0;
+    static bool awake = false;
+    static int64_t wokenUpAt;
+    static int64_t sessionStartedAt;
+    static Session::Stats current;
+    static Session::Stats last;
+
+    static bool isAwake()
+    {
+        return awake && esp_timer_get_time() - wokenUpAt < WATCHDOG_MARGIN;
+    }
+
+    Session::Session()
+    {
+        if (sessionDepth++ == 0)
+        {
+            memset(&current, 0, sizeof(current));
+            sessionStartedAt = esp_timer_get_time();
+        }
+    }
+
+    Session::~Session()
+    {
+        if (--sessionDepth > 0)
+        {
+            return;
+        }
+
+        if (isAwake())
+        {
+            atecc.idleMode();
+        }
+        awake = false;
+
+        current.duration = esp_timer_get_time() - sessionStartedAt;
+        last = current;
+    }
+
+    const Session::Stats &Session::getStats()
+    {
+        return last;
+    }
+
+    /**
+     * Wake the chip up unless it is still awake from a previous command of the session
+     *
+     * @return start time of the command
+     */
+    static int64_t beginCommand()
+    {
+        if (!isAwake())
+        {
+            atecc.wakeUp();
+            awake = true;
+            wokenUpAt = esp_timer_get_time();
+            current.wakeUps++;
+        }
+
+        return esp_timer_get_time();
+    }
+
+    static void endCommand(const int64_t startedAt)
+    {
+        current.commands++;
+        current.busy += esp_timer_get_time() - startedAt;
+    }
+
     bool init()
     {
         if (!atecc.begin())
@@ -89,26 +164,61 @@ namespace Crypto
 
     namespace SHA256
     {
-        bool hash(const uint8_t *data, const size_t length, uint8_t *sha)
+        bool hashSecureElement(const uint8_t *data, const size_t length, uint8_t *sha)
         {
-            atecc.wakeUp();
+            Session session;
+            const int64_t startedAt = beginCommand();
             atecc.sha256((uint8_t *)data, length, sha);
-            atecc.idleMode();
+            endCommand(startedAt);
 
             Serial.println(" * SHA256:");
             serialDumpBuffer(sha, 32);
 
             return true;
         }
+
+#if SHA256_BACKEND == SHA256_SECURE_ELEMENT
+        // the pieces are collected and sent in one go, the chip computes one hash at a time anyway
+        static uint8_t shaBuffer[SHA_BUFFER_SIZE];
+
+        void Context::init()
+        {
+            length = 0;
+            overflow = false;
+        }
+
+        void Context::update(const uint8_t *data, const size_t dataLength)
+        {
+            if (dataLength > SHA_BUFFER_SIZE - length)
+            {
+                overflow = true;
+                return;
+            }
+
+            memcpy(shaBuffer + length, data, dataLength);
+            length += dataLength;
+        }
+
+        bool Context::finalize(uint8_t *sha)
+        {
+            if (overflow)
+            {
+                return false;
+            }
+
+            return hashSecureElement(shaBuffer, length, sha);
+        }
+#endif
     } // namespace SHA256
 
     namespace ECDSA
     {
         void getPublicKey(PublicKey *publicKey)
         {
-            atecc.wakeUp();
+            Session session;
+            const int64_t startedAt = beginCommand();
             atecc.generatePublicKey();
-            atecc.idleMode();
+            endCommand(startedAt);
 
             memcpy(publicKey, atecc.publicKey64Bytes, 64);
 
@@ -119,9 +229,10 @@ namespace Crypto
 
         void sign(const uint8_t *hash, uint8_t *signature)
         {
-            atecc.wakeUp();
+            Session session;
+            const int64_t startedAt = beginCommand();
             atecc.createSignature((uint8_t *)hash);
-            atecc.idleMode();
+            endCommand(startedAt);
 
             memcpy(signature, atecc.signature, 64);
 
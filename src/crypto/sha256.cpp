@@ -0,0 +1,25 @@
+#include <Arduino.h>
+
+#include "config.h"
+#include "crypto/crypto.h"
+
+namespace Crypto
+{
+    namespace SHA256
+    {
+        /**
+         * Everything hashed here is public (RP IDs, authenticator data, client data hashes), it is not worth
+         * the I2C round trips to the secure element unless configured so
+         */
+        bool hash(const uint8_t *data, const size_t length, uint8_t *sha)
+        {
+#if SHA256_BACKEND == SHA256_SECURE_ELEMENT
+            return hashSecureElement(data, length, sha);
+#elif SHA256_BACKEND == SHA256_SOFTWARE
+            return hashSoftware(data, length, sha);
+#else
+            return hashMbedTLS(data, length, sha);
+#endif
+        }
+    } // namespace SHA256
+} // namespace Crypto
\ No newline at end of file
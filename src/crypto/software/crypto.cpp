@@ -21,6 +21,20 @@ namespace Crypto
     {
     }
 
+    Session::Session()
+    {
+    }
+
+    Session::~Session()
+    {
+    }
+
+    const Session::Stats &Session::getStats()
+    {
+        static const Stats stats = {};
+        return stats;
+    }
+
 } // namespace Crypto
 
 #endif
\ No newline at end of file
@@ -28,7 +28,7 @@ namespace Crypto
             Serial.println("Private Key:");
             serialDumpBuffer(privateKey.key, 32);
 
-            uECC_sign(privateKey.key, hash, 32, signature, _es256_curve);
+            sign(&privateKey, hash, signature);
         }
     } // namespace ECDSA
 } // namespace Crypto
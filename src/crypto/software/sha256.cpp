@@ -1,17 +1,16 @@
 #include <Arduino.h>
 
+#include <SHA256.h>
+#include <mbedtls/sha256.h>
+
 #include "config.h"
 #include "crypto/crypto.h"
 
-#if !defined(HARDWARE_CRYPTO)
-
-#include <SHA256.h>
-
 namespace Crypto
 {
     namespace SHA256
     {
-        bool hash(const uint8_t *data, const size_t length, uint8_t *sha)
+        bool hashSoftware(const uint8_t *data, const size_t length, uint8_t *sha)
         {
             ::SHA256 sha256;
 
@@ -21,7 +20,55 @@ namespace Crypto
 
             return true;
         }
-    } // namespace SHA256
-} // namespace Crypto
 
-#endif
\ No newline at end of file
+        /**
+         * mbedtls uses the SHA accelerator of the ESP32 when it is not busy with another hash
+         */
+        bool hashMbedTLS(const uint8_t *data, const size_t length, uint8_t *sha)
+        {
+            return mbedtls_sha256_ret(data, length, sha, 0) == 0;
+        }
+
+#if SHA256_BACKEND == SHA256_SOFTWARE
+        void Context::init()
+        {
+            sha256.reset();
+        }
+
+        void Context::update(const uint8_t *data, const size_t length)
+        {
+            sha256.update(data, length);
+        }
+
+        bool Context::finalize(uint8_t *sha)
+        {
+            sha256.finalize(sha, 32);
+
+            return true;
+        }
+#elif SHA256_BACKEND == SHA256_MBEDTLS
+        /**
+         * The SHA accelerator is held from the first block until the hash is finalized, the other hashes
+         * fall back to software meanwhile
+         */
+        void Context::init()
+        {
+            mbedtls_sha256_init(&sha256);
+            mbedtls_sha256_starts_ret(&sha256, 0);
+        }
+
+        void Context::update(const uint8_t *data, const size_t length)
+        {
+            mbedtls_sha256_update_ret(&sha256, data, length);
+        }
+
+        bool Context::finalize(uint8_t *sha)
+        {
+            const bool success = mbedtls_sha256_finish_ret(&sha256, sha) == 0;
+            mbedtls_sha256_free(&sha256);
+
+            return success;
+        }
+#endif
+    } // namespace SHA256
+} // namespace Crypto
\ No newline at end of file
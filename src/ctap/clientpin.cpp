@@ -1,11 +1,8 @@
-#include <memory>
-
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "crypto/crypto.h"
 #include "fido2/ctap/ctap.h"
+#include "fido2/ctap/schema.h"
 #include "util/util.h"
 
 namespace FIDO2
@@ -19,84 +16,38 @@ namespace FIDO2
                 return authenticatorClientPIN;
             }
 
-            Status parseClientPIN(const CBOR &cbor, std::unique_ptr<Command> &request)
+            template <>
+            struct Schema<ClientPIN>
             {
-                Serial.println("Parse ClientPIN");
-
-                if (!cbor.is_pair())
-                {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                }
-
-                std::unique_ptr<ClientPIN> rq(new ClientPIN());
-
-                CBORPair &cborPair = (CBORPair &)cbor;
-
-                // pinUvAuthProtocol (0x01)
-                CBOR cborPinUvAuthProtocol = cborPair.find_by_key((uint8_t)ClientPIN::keyPinUvAuthProtocol);
-                if (!cborPinUvAuthProtocol.is_uint8())
-                {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                }
-
-                rq->protocol = cborPinUvAuthProtocol;
-
-                // subCommand (0x02)
-                CBOR cborSubCommand = cborPair.find_by_key((uint8_t)ClientPIN::keySubCommand);
-                if (!cborSubCommand.is_uint8())
-                {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                }
-
-                rq->subCommand = (ClientPIN::SubCommand)(uint8_t)cborSubCommand;
-
-                // keyAgreement (0x03)
-                CBOR cborKeyAgreement = cborPair.find_by_key((uint8_t)ClientPIN::keyKeyAgreement);
-                if (!cborKeyAgreement.is_null())
-                {
-                    if (parsePublicKey(cborKeyAgreement, &rq->publicKey) != CTAP2_OK)
-                    {
-                        RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                    }
-                }
-
-                // pinUvAuthParam (0x04)
-                CBOR cborPinUvAuthParam = cborPair.find_by_key((uint8_t)ClientPIN::keyPinUvAuthParam);
-                if (!cborPinUvAuthParam.is_null())
-                {
-                    if (!cborPinUvAuthParam.is_bytestring() || cborPinUvAuthParam.get_bytestring_len() != 16)
-                    {
-                        RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                    }
-
-                    cborPinUvAuthParam.get_bytestring(rq->pinUvAuthParam);
-                }
-
-                // newPinEnc (0x05)
-                CBOR cborNewPinEnc = cborPair.find_by_key((uint8_t)ClientPIN::keyNewPinEnc);
-                if (!cborNewPinEnc.is_null())
+                static constexpr Field<ClientPIN> fields[] = {
+                    // pinUvAuthProtocol (0x01)
+                    {ClientPIN::keyPinUvAuthProtocol, Decoder::TYPE_UNSIGNED, true, UINT8_MAX, readInteger<ClientPIN, uint8_t, &ClientPIN::protocol>},
+                    // subCommand (0x02)
+                    {ClientPIN::keySubCommand, Decoder::TYPE_UNSIGNED, true, UINT8_MAX, readInteger<ClientPIN, ClientPIN::SubCommand, &ClientPIN::subCommand>},
+                    // keyAgreement (0x03)
+                    {ClientPIN::keyKeyAgreement, Decoder::TYPE_MAP, false, 0, readStruct<ClientPIN, Crypto::ECDSA::PublicKey, &ClientPIN::publicKey, parsePublicKey>},
+                    // pinUvAuthParam (0x04)
+                    {ClientPIN::keyPinUvAuthParam, Decoder::TYPE_BYTES, false, 16, readFixedBytes<ClientPIN, 16, &ClientPIN::pinUvAuthParam>},
+                    // newPinEnc (0x05)
+                    {ClientPIN::keyNewPinEnc, Decoder::TYPE_BYTES, false, 64, readFixedBytes<ClientPIN, 64, &ClientPIN::newPinEnc>},
+                    // pinHashEnc (0x06)
+                    {ClientPIN::keyPinHashEnc, Decoder::TYPE_BYTES, false, 16, readFixedBytes<ClientPIN, 16, &ClientPIN::pinHashEnc>},
+                };
+            };
+
+            constexpr Field<ClientPIN> Schema<ClientPIN>::fields[];
+
+            Status parseClientPIN(Decoder &decoder, Arena &arena, Command **request)
+            {
+                ClientPIN *rq = arena.create<ClientPIN>();
+                if (rq == nullptr)
                 {
-                    if (!cborNewPinEnc.is_bytestring() || cborNewPinEnc.get_bytestring_len() != 64)
-                    {
-                        RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                    }
-
-                    cborNewPinEnc.get_bytestring(rq->newPinEnc);
+                    RETURN_ERROR(CTAP2_ERR_REQUEST_TOO_LARGE);
                 }
 
-                // pinHashEnc (0x06)
-                CBOR cborPinHashEnc = cborPair.find_by_key((uint8_t)ClientPIN::keyPinHashEnc);
-                if (!cborPinHashEnc.is_null())
-                {
-                    if (!cborPinHashEnc.is_bytestring() || cborPinHashEnc.get_bytestring_len() != 16)
-                    {
-                        RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                    }
-
-                    cborPinHashEnc.get_bytestring(rq->pinHashEnc);
-                }
+                RETURN_IF_ERROR(decodeMap(decoder, rq));
 
-                request = std::unique_ptr<Command>(rq.release());
+                *request = rq;
 
                 return CTAP2_OK;
             }
@@ -110,77 +61,72 @@ namespace FIDO2
                 return authenticatorClientPIN;
             }
 
-            Status encode(const ClientPIN *response, std::unique_ptr<CBOR> &cbor)
+            Status encode(const ClientPIN *response, Encoder &encoder)
             {
-                // use external buffer?
-                std::unique_ptr<CBORPair> cborPair(new CBORPair());
+                const size_t count = response->present.publicKey +
+                                     response->present.pinUvAuthToken +
+                                     response->present.pinRetries +
+                                     response->present.powerCycleState +
+                                     response->present.uvRetries;
+
+                // the response has no parameters
+                if (count == 0)
+                {
+                    return CTAP2_OK;
+                }
 
-                bool do_it = false;
+                RETURN_IF_ERROR(encoder.writeMap(count));
 
-                if (response->publicKey != nullptr)
+                if (response->present.publicKey)
                 {
-                    CBORPair cborKey;
+                    RETURN_IF_ERROR(encoder.writeInt(0x01));
+                    RETURN_IF_ERROR(encoder.writeMap(5));
 
                     // kty: EC2 key type
-                    cborKey.append(1, 2);
+                    RETURN_IF_ERROR(encoder.writeInt(1));
+                    RETURN_IF_ERROR(encoder.writeInt(2));
 
                     // alg: algorithm ECDH-ES + HKDF-256
                     // Note: The COSEAlgorithmIdentifier used is -25 (ECDH-ES + HKDF-256) although this is NOT the algorithm actually used.
                     // Setting this to a different value may result in compatibility issues.
-                    cborKey.append(3, -25);
+                    RETURN_IF_ERROR(encoder.writeInt(3));
+                    RETURN_IF_ERROR(encoder.writeInt(-25));
 
                     // crv: P-256 curve
-                    cborKey.append(-1, 1);
+                    RETURN_IF_ERROR(encoder.writeInt(-1));
+                    RETURN_IF_ERROR(encoder.writeInt(1));
 
                     // x-coordinate as byte string 32 bytes in length
-                    CBOR cborX;
-                    cborX.encode(response->publicKey->x, 32);
-                    cborKey.append(-2, cborX);
+                    RETURN_IF_ERROR(encoder.writeInt(-2));
+                    RETURN_IF_ERROR(encoder.writeBytes(response->publicKey.x, 32));
 
                     // y-coordinate as byte string 32 bytes in length
-                    CBOR cborY;
-                    cborY.encode(response->publicKey->y, 32);
-                    cborKey.append(-3, cborY);
-
-                    cborPair->append(0x01, cborKey);
-
-                    do_it = true;
+                    RETURN_IF_ERROR(encoder.writeInt(-3));
+                    RETURN_IF_ERROR(encoder.writeBytes(response->publicKey.y, 32));
                 }
 
-                if (response->pinUvAuthToken != nullptr)
+                if (response->present.pinUvAuthToken)
                 {
-                    CBOR cborPinUvAuthToken;
-                    cborPinUvAuthToken.encode(response->pinUvAuthToken->value, response->pinUvAuthToken->maxLength);
-                    cborPair->append(0x02, cborPinUvAuthToken);
-
-                    do_it = true;
+                    RETURN_IF_ERROR(encoder.writeInt(0x02));
+                    RETURN_IF_ERROR(encoder.writeBytes(response->pinUvAuthToken.value, response->pinUvAuthToken.maxLength));
                 }
 
-                if (response->pinRetries != nullptr)
+                if (response->present.pinRetries)
                 {
-                    cborPair->append(0x03, *response->pinRetries);
-
-                    do_it = true;
+                    RETURN_IF_ERROR(encoder.writeInt(0x03));
+                    RETURN_IF_ERROR(encoder.writeInt(response->pinRetries));
                 }
 
-                if (response->powerCycleState != nullptr)
+                if (response->present.powerCycleState)
                 {
-                    cborPair->append(0x04, *response->powerCycleState);
-
-                    do_it = true;
-                }
-
-                if (response->uvRetries != nullptr)
-                {
-                    cborPair->append(0x04, *response->uvRetries);
-
-                    do_it = true;
+                    RETURN_IF_ERROR(encoder.writeInt(0x04));
+                    RETURN_IF_ERROR(encoder.writeBool(response->powerCycleState));
                 }
 
-                // finalize the encoding
-                if (do_it)
+                if (response->present.uvRetries)
                 {
-                    cbor = std::unique_ptr<CBOR>(new CBOR(*cborPair));
+                    RETURN_IF_ERROR(encoder.writeInt(0x05));
+                    RETURN_IF_ERROR(encoder.writeInt(response->uvRetries));
                 }
 
                 return CTAP2_OK;
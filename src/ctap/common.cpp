@@ -1,7 +1,5 @@
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "fido2/ctap/ctap.h"
 #include "util/util.h"
 #include <memory>
@@ -12,167 +10,307 @@ namespace FIDO2
     {
         namespace Request
         {
-            Status parseRpEntity(const CBOR &cbor, PublicKeyCredentialRpEntity *rp)
+            Status parseRpEntity(Decoder &decoder, PublicKeyCredentialRpEntity *rp)
             {
-                if (!cbor.is_pair())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
-
-                CBORPair &cborPair = (CBORPair &)cbor;
-
-                //
-                CBOR cborId = cborPair.find_by_key("id");
-                if (!cborId.is_string())
+                size_t count;
+                if (decoder.readMap(count) != CTAP2_OK)
                 {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
+                    RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
                 }
-                cborId.get_string(rp->id);
 
-                //
-                CBOR cborName = cborPair.find_by_key("name");
-                if (!cborName.is_null())
+                for (size_t i = 0; i < count; i++)
                 {
-                    if (!cborName.is_string())
+                    StringView key;
+                    if (decoder.readText(key) != CTAP2_OK)
                     {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
+                        RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
                     }
 
-                    cborName.get_string(rp->name);
-                }
-
-                //
-                CBOR cborIcon = cborPair.find_by_key("icon");
-                if (!cborIcon.is_null())
-                {
-                    if (!cborIcon.is_string())
+                    //
+                    if (key.equals("id"))
+                    {
+                        if (decoder.readText(rp->id) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
+                        }
+                    }
+                    //
+                    else if (key.equals("name"))
+                    {
+                        if (decoder.readText(rp->name) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                        }
+                    }
+                    //
+                    else if (key.equals("icon"))
+                    {
+                        if (decoder.readText(rp->icon) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                        }
+                    }
+                    else if (decoder.skip() != CTAP2_OK)
                     {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
+                        RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
                     }
+                }
 
-                    cborIcon.get_string(rp->icon);
+                if (!rp->id.isPresent())
+                {
+                    RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
                 }
 
                 return CTAP2_OK;
             }
 
-            Status parseUserEntity(const CBOR &cbor, PublicKeyCredentialUserEntity *user)
+            Status parseUserEntity(Decoder &decoder, PublicKeyCredentialUserEntity *user)
             {
-                if (!cbor.is_pair())
+                size_t count;
+                if (decoder.readMap(count) != CTAP2_OK)
                 {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
+                    RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
                 }
 
-                CBORPair &cborPair = (CBORPair &)cbor;
-
-                //
-                CBOR cborId = cborPair.find_by_key("id");
-                if (!cborId.is_bytestring())
+                for (size_t i = 0; i < count; i++)
                 {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                }
-                user->id.alloc(cborId.get_bytestring_len());
-                cborId.get_bytestring(user->id.value);
-
-                //
-                CBOR cborName = cborPair.find_by_key("name");
-                if (!cborName.is_null())
-                {
-                    if (!cborName.is_string())
+                    StringView key;
+                    if (decoder.readText(key) != CTAP2_OK)
                     {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
+                        RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
                     }
 
-                    cborName.get_string(user->name);
+                    //
+                    if (key.equals("id"))
+                    {
+                        if (decoder.readBytes(user->id) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
+                        }
+                        // user handle is at most 64 bytes
+                        if (user->id.length > 64)
+                        {
+                            RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
+                        }
+                    }
+                    //
+                    else if (key.equals("name"))
+                    {
+                        if (decoder.readText(user->name) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                        }
+                    }
+                    //
+                    else if (key.equals("displayName"))
+                    {
+                        if (decoder.readText(user->displayName) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                        }
+                    }
+                    //
+                    else if (key.equals("icon"))
+                    {
+                        if (decoder.readText(user->icon) != CTAP2_OK)
+                        {
+                            RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                        }
+                    }
+                    else if (decoder.skip() != CTAP2_OK)
+                    {
+                        RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
+                    }
                 }
 
-                //
-                CBOR cborDisplayName = cborPair.find_by_key("displayName");
-                if (!cborDisplayName.is_null())
+                if (!user->id.isPresent())
                 {
-                    if (!cborDisplayName.is_string())
-                    {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
-                    }
+                    RETURN_ERROR(CTAP2_ERR_INVALID_CBOR);
+                }
 
-                    cborDisplayName.get_string(user->displayName);
+                return CTAP2_OK;
+            }
+
+            Status parsePublicKey(Decoder &decoder, Crypto::ECDSA::PublicKey *key)
+            {
+                size_t count;
+                if (decoder.readMap(count) != CTAP2_OK)
+                {
+                    RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
                 }
 
-                //
-                CBOR cborIcon = cborPair.find_by_key("icon");
-                if (!cborIcon.is_null())
+                bool hasX = false;
+                bool hasY = false;
+                for (size_t i = 0; i < count; i++)
                 {
-                    if (!cborIcon.is_string())
+                    int32_t label;
+                    if (decoder.readInt(label) != CTAP2_OK)
                     {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
+                        RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
                     }
 
-                    cborIcon.get_string(user->icon);
+                    // x-coordinate (-2) and y-coordinate (-3), the other parameters are implied by the protocol
+                    if (label == -2 || label == -3)
+                    {
+                        ByteView coordinate;
+                        if (decoder.readBytes(coordinate) != CTAP2_OK || coordinate.length != 32)
+                        {
+                            RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
+                        }
+
+                        if (label == -2)
+                        {
+                            memcpy(key->x, coordinate.data, 32);
+                            hasX = true;
+                        }
+                        else
+                        {
+                            memcpy(key->y, coordinate.data, 32);
+                            hasY = true;
+                        }
+                    }
+                    else if (decoder.skip() != CTAP2_OK)
+                    {
+                        RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
+                    }
+                }
+
+                if (!hasX || !hasY)
+                {
+                    RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
                 }
 
                 return CTAP2_OK;
             }
+        } // namespace Request
 
-            Status parsePublicKey(const CBOR &cbor, Crypto::ECDSA::PublicKey *key)
+        Status decode(Decoder &decoder, PublicKeyCredentialDescriptor *descriptor)
+        {
+            size_t count;
+            Status status = decoder.readMap(count);
+            if (status != CTAP2_OK)
             {
-                if (!cbor.is_pair())
+                return status;
+            }
+
+            descriptor->type = StringView();
+            descriptor->credentialId = ByteView();
+
+            for (size_t i = 0; i < count; i++)
+            {
+                StringView key;
+                status = decoder.readText(key);
+                if (status != CTAP2_OK)
                 {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
+                    return status;
                 }
 
-                CBORPair &cborPair = (CBORPair &)cbor;
-
-                //
+                if (key.equals("type"))
+                {
+                    status = decoder.readText(descriptor->type);
+                }
+                else if (key.equals("id"))
+                {
+                    status = decoder.readBytes(descriptor->credentialId);
+                    if (status == CTAP2_OK && descriptor->credentialId.length > CREDENTIAL_ID_LENGTH)
+                    {
+                        status = CTAP1_ERR_INVALID_PARAMETER;
+                    }
+                }
+                else
+                {
+                    status = decoder.skip();
+                }
 
-                //
-                CBOR cborX = cborPair.find_by_key(-2);
-                if (!cborX.is_bytestring() || cborX.get_bytestring_len() != 32)
+                if (status != CTAP2_OK)
                 {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
+                    return status;
                 }
+            }
+
+            if (!descriptor->type.isPresent() || !descriptor->credentialId.isPresent())
+            {
+                return CTAP2_ERR_MISSING_PARAMETER;
+            }
 
-                cborX.get_bytestring(key->x);
+            return CTAP2_OK;
+        }
 
-                //
-                CBOR cborY = cborPair.find_by_key(-3);
-                if (!cborY.is_bytestring() || cborY.get_bytestring_len() != 32)
+        Status decode(Decoder &decoder, PublicKeyCredentialParameters *parameters)
+        {
+            size_t count;
+            Status status = decoder.readMap(count);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            parameters->type = StringView();
+
+            bool hasAlg = false;
+            for (size_t i = 0; i < count; i++)
+            {
+                StringView key;
+                status = decoder.readText(key);
+                if (status != CTAP2_OK)
                 {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
+                    return status;
                 }
 
-                cborY.get_bytestring(key->y);
+                if (key.equals("type"))
+                {
+                    status = decoder.readText(parameters->type);
+                }
+                else if (key.equals("alg"))
+                {
+                    status = decoder.readInt(parameters->alg);
+                    hasAlg = true;
+                }
+                else
+                {
+                    status = decoder.skip();
+                }
 
-                return CTAP2_OK;
+                if (status != CTAP2_OK)
+                {
+                    return status;
+                }
             }
-        } // namespace Request
+
+            if (!parameters->type.isPresent() || !hasAlg)
+            {
+                return CTAP2_ERR_MISSING_PARAMETER;
+            }
+
+            return CTAP2_OK;
+        }
 
         namespace Response
         {
             void encodePublicKey(Crypto::ECDSA::PublicKey *publicKey, uint8_t *encodedKey)
             {
-                // use external buffer?
-                CBORPair cborPair;
+                Encoder encoder(encodedKey, sizeof(AttestedCredentialData::publicKey));
+                encoder.writeMap(5);
 
                 // kty: EC2 key type
-                cborPair.append(1, 2);
+                encoder.writeInt(1);
+                encoder.writeInt(2);
 
                 // alg: ES256 signature algorithm
-                cborPair.append(3, -7);
+                encoder.writeInt(3);
+                encoder.writeInt(-7);
 
                 // crv: P-256 curve
-                cborPair.append(-1, 1);
+                encoder.writeInt(-1);
+                encoder.writeInt(1);
 
                 // x-coordinate as byte string 32 bytes in length
-                CBOR cborX;
-                cborX.encode(publicKey->x, 32);
-                cborPair.append(-2, cborX);
+                encoder.writeInt(-2);
+                encoder.writeBytes(publicKey->x, 32);
 
                 // y-coordinate as byte string 32 bytes in length
-                CBOR cborY;
-                cborY.encode(publicKey->y, 32);
-                cborPair.append(-3, cborY);
-
-                memcpy(encodedKey, cborPair.to_CBOR(), cborPair.length());
+                encoder.writeInt(-3);
+                encoder.writeBytes(publicKey->y, 32);
             }
         } // namespace Response
     }     // namespace CTAP
@@ -1,5 +1,3 @@
-#include <memory>
-
 #include <Arduino.h>
 
 #include "fido2/ctap/ctap.h"
@@ -11,55 +9,62 @@ namespace FIDO2
     {
         namespace Request
         {
-            Status parse(const uint8_t *data, const size_t len, std::unique_ptr<Command> &request)
+            static Status parseCommand(const CommandCode command, Decoder &decoder, Arena &arena, Command **request)
             {
-                CBOR cbor;
-                if (len > 1)
-                {
-                    cbor = CBOR((uint8_t *)data + 1, len - 1, true);
-                }
-
-                switch ((CommandCode)data[0])
+                switch (command)
                 {
                 case authenticatorGetInfo:
-                    return parseGetInfo(cbor, request);
+                    return parseGetInfo(decoder, arena, request);
                 case authenticatorGetAssertion:
-                    return parseGetAssertion(cbor, request);
+                    return parseGetAssertion(decoder, arena, request);
                 case authenticatorMakeCredential:
-                    return parseMakeCredential(cbor, request);
+                    return parseMakeCredential(decoder, arena, request);
                 case authenticatorClientPIN:
-                    return parseClientPIN(cbor, request);
+                    return parseClientPIN(decoder, arena, request);
                 case authenticatorReset:
-                    return parseReset(cbor, request);
+                    return parseReset(decoder, arena, request);
                 default:
                     break;
                 }
 
-                RAISE(Exception(CTAP1_ERR_INVALID_COMMAND));
+                RETURN_ERROR(CTAP1_ERR_INVALID_COMMAND);
+            }
+
+            Status parse(const uint8_t *data, const size_t len, Arena &arena, Command **request)
+            {
+                if (len == 0)
+                {
+                    RETURN_ERROR(CTAP1_ERR_INVALID_LENGTH);
+                }
+
+                // the parameters are decoded in place, directly from the command buffer
+                Decoder decoder(data + 1, len - 1);
+
+                return parseCommand((CommandCode)data[0], decoder, arena, request);
             }
         } // namespace Request
 
         namespace Response
         {
-            Status encode(const Command *response, std::unique_ptr<CBOR> &cbor)
+            Status encode(const Command *response, Encoder &encoder)
             {
                 switch (response->getCommandCode())
                 {
                 case authenticatorGetInfo:
-                    return encode((Response::GetInfo *)response, cbor);
+                    return encode((Response::GetInfo *)response, encoder);
                 case authenticatorGetAssertion:
-                    return encode((Response::GetAssertion *)response, cbor);
+                    return encode((Response::GetAssertion *)response, encoder);
                 case authenticatorMakeCredential:
-                    return encode((Response::MakeCredential *)response, cbor);
+                    return encode((Response::MakeCredential *)response, encoder);
                 case authenticatorClientPIN:
-                    return encode((Response::ClientPIN *)response, cbor);
+                    return encode((Response::ClientPIN *)response, encoder);
                 case authenticatorReset:
-                    return encode((Response::Reset *)response, cbor);
+                    return encode((Response::Reset *)response, encoder);
                 default:
                     break;
                 }
 
-                RAISE(Exception(CTAP1_ERR_INVALID_COMMAND));
+                RETURN_ERROR(CTAP1_ERR_INVALID_COMMAND);
             }
         } // namespace Response
     }     // namespace CTAP
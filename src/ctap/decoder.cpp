@@ -0,0 +1,346 @@
+#include <Arduino.h>
+
+#include "fido2/ctap/decoder.h"
+
+// additional information values of the initial byte
+#define INFO_UINT8 24
+#define INFO_UINT16 25
+#define INFO_UINT32 26
+#define INFO_UINT64 27
+
+#define SIMPLE_FALSE 20
+#define SIMPLE_TRUE 21
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        Decoder::Decoder(const uint8_t *data, const size_t length) : data(data), length(length), position(0), remaining(), depth(0)
+        {
+        }
+
+        bool Decoder::atEnd() const
+        {
+            return position >= length;
+        }
+
+        size_t Decoder::getPosition() const
+        {
+            return position;
+        }
+
+        ByteView Decoder::slice(const size_t from) const
+        {
+            ByteView view;
+            view.data = data + from;
+            view.length = position - from;
+
+            return view;
+        }
+
+        Status Decoder::peekType(MajorType &type) const
+        {
+            if (atEnd())
+            {
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            type = (MajorType)(data[position] >> 5);
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::peekHeader(MajorType &type, uint64_t &argument) const
+        {
+            Decoder decoder(*this);
+
+            uint8_t initial;
+            Status status = decoder.readHeader(initial, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            type = (MajorType)initial;
+
+            return CTAP2_OK;
+        }
+
+        /**
+         * Read the initial byte and the argument following it
+         */
+        Status Decoder::readHeader(uint8_t &type, uint64_t &value)
+        {
+            if (atEnd())
+            {
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            const uint8_t initial = data[position++];
+            type = initial >> 5;
+
+            const uint8_t info = initial & 0x1f;
+            if (info < INFO_UINT8)
+            {
+                value = info;
+                return track(type, value);
+            }
+
+            size_t size;
+            switch (info)
+            {
+            case INFO_UINT8:
+                size = 1;
+                break;
+            case INFO_UINT16:
+                size = 2;
+                break;
+            case INFO_UINT32:
+                size = 4;
+                break;
+            case INFO_UINT64:
+                size = 8;
+                break;
+            default:
+                // reserved values and indefinite length items
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            if (length - position < size)
+            {
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            value = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+                value = (value << 8) | data[position++];
+            }
+
+            return track(type, value);
+        }
+
+        /**
+         * Count the item against the container it is in and enter it when it is an array or a map
+         */
+        Status Decoder::track(const uint8_t type, const uint64_t argument)
+        {
+            // a tag and the item following it count as one
+            if (type == TYPE_TAG)
+            {
+                return CTAP2_OK;
+            }
+
+            if (depth > 0)
+            {
+                remaining[depth - 1]--;
+            }
+
+            if (type == TYPE_ARRAY || type == TYPE_MAP)
+            {
+                if (depth == FIDO2_CBOR_MAX_DEPTH)
+                {
+                    return CTAP2_ERR_REQUEST_TOO_LARGE;
+                }
+
+                if (argument > (type == TYPE_ARRAY ? FIDO2_CBOR_MAX_ARRAY_LENGTH : FIDO2_CBOR_MAX_MAP_SIZE))
+                {
+                    return CTAP2_ERR_LIMIT_EXCEEDED;
+                }
+
+                // every element takes at least one byte
+                const uint64_t items = type == TYPE_ARRAY ? argument : argument * 2;
+                if (items > length - position)
+                {
+                    return CTAP2_ERR_INVALID_CBOR;
+                }
+
+                if (items > 0)
+                {
+                    remaining[depth++] = items;
+                }
+            }
+
+            // leave the containers which have been read completely
+            while (depth > 0 && remaining[depth - 1] == 0)
+            {
+                depth--;
+            }
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readInt(int32_t &value)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_UNSIGNED && type != TYPE_NEGATIVE)
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            if (argument > INT32_MAX)
+            {
+                return CTAP1_ERR_INVALID_PARAMETER;
+            }
+
+            value = type == TYPE_UNSIGNED ? (int32_t)argument : -1 - (int32_t)argument;
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readBool(bool &value)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_SIMPLE || (argument != SIMPLE_FALSE && argument != SIMPLE_TRUE))
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            value = argument == SIMPLE_TRUE;
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readBytes(ByteView &value)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_BYTES)
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            if (argument > length - position)
+            {
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            value.data = data + position;
+            value.length = argument;
+            position += argument;
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readText(StringView &value)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_TEXT)
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            if (argument > length - position)
+            {
+                return CTAP2_ERR_INVALID_CBOR;
+            }
+
+            value.data = (const char *)data + position;
+            value.length = argument;
+            position += argument;
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readArray(size_t &count)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_ARRAY)
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            count = argument;
+
+            return CTAP2_OK;
+        }
+
+        Status Decoder::readMap(size_t &count)
+        {
+            uint8_t type;
+            uint64_t argument;
+            Status status = readHeader(type, argument);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            if (type != TYPE_MAP)
+            {
+                return CTAP2_ERR_CBOR_UNEXPECTED_TYPE;
+            }
+
+            count = argument;
+
+            return CTAP2_OK;
+        }
+
+        /**
+         * Items are read until the container the skipped item opened has been left, so the stack usage
+         * does not depend on the input
+         */
+        Status Decoder::skip()
+        {
+            const uint8_t start = depth;
+
+            bool complete = false;
+            while (!complete)
+            {
+                uint8_t type;
+                uint64_t argument;
+                Status status = readHeader(type, argument);
+                if (status != CTAP2_OK)
+                {
+                    return status;
+                }
+
+                if (type == TYPE_BYTES || type == TYPE_TEXT)
+                {
+                    if (argument > length - position)
+                    {
+                        return CTAP2_ERR_INVALID_CBOR;
+                    }
+                    position += argument;
+                }
+
+                complete = type != TYPE_TAG && depth <= start;
+            }
+
+            return CTAP2_OK;
+        }
+    } // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <Arduino.h>
+
+#include "fido2/ctap/decoder.h"
+#include "fido2/ctap/encoder.h"
+
+// additional information values of the initial byte
+#define INFO_UINT8 24
+#define INFO_UINT16 25
+#define INFO_UINT32 26
+
+#define SIMPLE_FALSE 20
+#define SIMPLE_TRUE 21
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        Encoder::Encoder(uint8_t *data, const size_t maxLength) : data(data), maxLength(maxLength), position(0)
+        {
+        }
+
+        size_t Encoder::getLength() const
+        {
+            return position;
+        }
+
+        /**
+         * Write the initial byte followed by the argument in the shortest form
+         */
+        Status Encoder::writeHeader(const uint8_t type, const uint32_t argument)
+        {
+            uint8_t header[5];
+            size_t size;
+
+            if (argument < INFO_UINT8)
+            {
+                header[0] = type << 5 | argument;
+                size = 1;
+            }
+            else if (argument <= UINT8_MAX)
+            {
+                header[0] = type << 5 | INFO_UINT8;
+                header[1] = argument;
+                size = 2;
+            }
+            else if (argument <= UINT16_MAX)
+            {
+                header[0] = type << 5 | INFO_UINT16;
+                header[1] = argument >> 8;
+                header[2] = argument;
+                size = 3;
+            }
+            else
+            {
+                header[0] = type << 5 | INFO_UINT32;
+                header[1] = argument >> 24;
+                header[2] = argument >> 16;
+                header[3] = argument >> 8;
+                header[4] = argument;
+                size = 5;
+            }
+
+            return writeRaw(header, size);
+        }
+
+        Status Encoder::writeRaw(const uint8_t *value, const size_t length)
+        {
+            if (length > maxLength - position)
+            {
+                return CTAP2_ERR_REQUEST_TOO_LARGE;
+            }
+
+            memcpy(data + position, value, length);
+            position += length;
+
+            return CTAP2_OK;
+        }
+
+        Status Encoder::writeInt(const int32_t value)
+        {
+            if (value < 0)
+            {
+                return writeHeader(Decoder::TYPE_NEGATIVE, -1 - value);
+            }
+
+            return writeHeader(Decoder::TYPE_UNSIGNED, value);
+        }
+
+        Status Encoder::writeBool(const bool value)
+        {
+            return writeHeader(Decoder::TYPE_SIMPLE, value ? SIMPLE_TRUE : SIMPLE_FALSE);
+        }
+
+        Status Encoder::writeBytesHeader(const size_t length)
+        {
+            return writeHeader(Decoder::TYPE_BYTES, length);
+        }
+
+        Status Encoder::writeBytes(const uint8_t *value, const size_t length)
+        {
+            Status status = writeBytesHeader(length);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            return writeRaw(value, length);
+        }
+
+        Status Encoder::writeText(const char *value)
+        {
+            const size_t length = strlen(value);
+
+            Status status = writeHeader(Decoder::TYPE_TEXT, length);
+            if (status != CTAP2_OK)
+            {
+                return status;
+            }
+
+            return writeRaw((const uint8_t *)value, length);
+        }
+
+        Status Encoder::writeArray(const size_t count)
+        {
+            return writeHeader(Decoder::TYPE_ARRAY, count);
+        }
+
+        Status Encoder::writeMap(const size_t count)
+        {
+            return writeHeader(Decoder::TYPE_MAP, count);
+        }
+    } // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
@@ -1,10 +1,7 @@
-#include <memory>
-
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "fido2/ctap/ctap.h"
+#include "fido2/ctap/schema.h"
 #include "util/util.h"
 
 namespace FIDO2
@@ -18,161 +15,37 @@ namespace FIDO2
                 return authenticatorGetAssertion;
             }
 
-            Status parseAllowList(CBOR &cbor, GetAssertion *request)
+            template <>
+            struct Schema<GetAssertion>
             {
-                if (!cbor.is_array())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
-
-                CBORArray &cborArray = (CBORArray &)cbor;
-
-                for (size_t i = 0; i < cborArray.n_elements(); i++)
-                {
-                    CBOR param = cborArray.at(i);
-
-                    if (!param.is_pair())
-                    {
-                        RAISE(Exception(CTAP2_ERR_CBOR_UNEXPECTED_TYPE));
-                    }
-
-                    std::unique_ptr<PublicKeyCredentialDescriptor> cd(new PublicKeyCredentialDescriptor());
-
-                    //
-                    CBOR cborType = param.find_by_key("type");
-                    if (!cborType.is_string())
-                    {
-                        RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                    }
-
-                    cborType.get_string(cd->type);
-
-                    //
-                    CBOR cborId = param.find_by_key("id");
-                    if(!cborId.is_bytestring() || cborId.get_bytestring_len() > CREDENTIAL_ID_LENGTH)
-                    {
-                        RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                    }
-
-                    cborId.get_bytestring(cd->credentialId.value);
-
-                    request->allowList.push_back(std::move(cd));
-                }
-
-                return CTAP2_OK;
-            }
-
-            Status parseExtensions(CBOR &cbor, GetAssertion *request)
+                static constexpr Field<GetAssertion> fields[] = {
+                    // rpId (0x01)
+                    {GetAssertion::keyRpId, Decoder::TYPE_TEXT, true, 0, readStringView<GetAssertion, &GetAssertion::rpId>},
+                    // clientDataHash (0x02)
+                    {GetAssertion::keyClientDataHash, Decoder::TYPE_BYTES, true, 32, readFixedBytes<GetAssertion, 32, &GetAssertion::clientDataHash>},
+                    // allowList (0x03)
+                    {GetAssertion::keyAllowList, Decoder::TYPE_ARRAY, false, 0, readArrayView<GetAssertion, PublicKeyCredentialDescriptor, &GetAssertion::allowList>},
+                    // extensions (0x04)
+                    {GetAssertion::keyExtensions, Decoder::TYPE_MAP, false, 0, skipValue<GetAssertion>},
+                    // options (0x05)
+                    {GetAssertion::keyOptions, Decoder::TYPE_MAP, false, 0, skipValue<GetAssertion>},
+                    // pinUvAuthParam (0x06) and pinUvAuthProtocol (0x07) are not used yet
+                };
+            };
+
+            constexpr Field<GetAssertion> Schema<GetAssertion>::fields[];
+
+            Status parseGetAssertion(Decoder &decoder, Arena &arena, Command **request)
             {
-                if (!cbor.is_pair())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
-
-                return CTAP2_OK;
-            }
-
-            Status parseOptions(CBOR &cbor, GetAssertion *request)
-            {
-                if (!cbor.is_pair())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
-
-                return CTAP2_OK;
-            }
-
-            Status parseGetAssertion(const CBOR &cbor, std::unique_ptr<Command> &request)
-            {
-                Serial.println("Parse GetAssertion");
-
-                if (!cbor.is_pair())
-                {
-                    RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                }
-
-                CBORPair &cborPair = (CBORPair &)cbor;
-
-                std::unique_ptr<GetAssertion> rq(new GetAssertion());
-
-                // rpId (0x01)
-                CBOR cborRpId = cborPair.find_by_key((uint8_t)GetAssertion::keyRpId);
-                if (cborRpId.is_null())
-                {
-                    RAISE(Exception(CTAP2_ERR_MISSING_PARAMETER));
-                }
-
-                if (!cborRpId.is_string())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
-
-                cborRpId.get_string(rq->rpId);
-
-                // clientDataHash (0x02)
-                CBOR cborClientDataHash = cborPair.find_by_key((uint8_t)GetAssertion::keyClientDataHash);
-                if (cborClientDataHash.is_null())
+                GetAssertion *rq = arena.create<GetAssertion>();
+                if (rq == nullptr)
                 {
-                    RAISE(Exception(CTAP2_ERR_MISSING_PARAMETER));
+                    RETURN_ERROR(CTAP2_ERR_REQUEST_TOO_LARGE);
                 }
 
-                if (!cborClientDataHash.is_bytestring())
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_PARAMETER));
-                }
+                RETURN_IF_ERROR(decodeMap(decoder, rq));
 
-                if (cborClientDataHash.get_bytestring_len() != 32)
-                {
-                    RAISE(Exception(CTAP1_ERR_INVALID_LENGTH));
-                }
-
-                cborClientDataHash.get_bytestring(rq->clientDataHash);
-
-                // allowList (0x03)
-                CBOR cborAllowList = cborPair.find_by_key((uint8_t)GetAssertion::keyAllowList);
-                if (!cborAllowList.is_null())
-                {
-                    if (parseAllowList(cborAllowList, rq.get()) != CTAP2_OK)
-                    {
-                        RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                    }
-                }
-
-                // extensions (0x04)
-                CBOR cborExtensions = cborPair.find_by_key((uint8_t)GetAssertion::keyExtensions);
-                if (!cborExtensions.is_null())
-                {
-                    if (parseExtensions(cborExtensions, rq.get()) != CTAP2_OK)
-                    {
-                        RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                    }
-                }
-
-                // options (0x05)
-                CBOR cborOptions = cborPair.find_by_key((uint8_t)GetAssertion::keyOptions);
-                if (!cborOptions.is_null())
-                {
-                    if (parseOptions(cborOptions, rq.get()) != CTAP2_OK)
-                    {
-                        RAISE(Exception(CTAP2_ERR_INVALID_CBOR));
-                    }
-                }
-
-                // pinUvAuthParam (0x06)
-                CBOR cborPinUvAuthParam = cborPair.find_by_key((uint8_t)GetAssertion::keyPinUvAuthParam);
-                if (!cborPinUvAuthParam.is_null())
-                {
-
-                }
-
-                // pinUvAuthProtocol (0x07)
-                CBOR cborPinUvAuthProtocol = cborPair.find_by_key((uint8_t)GetAssertion::keyPinUvAuthProtocol);
-                if (!cborPinUvAuthProtocol.is_null())
-                {
-
-                }
-
-                request = std::unique_ptr<Command>(rq.release());
+                *request = rq;
 
                 return CTAP2_OK;
             }
@@ -185,22 +58,26 @@ namespace FIDO2
                 return authenticatorGetAssertion;
             }
 
-            Status encode(const GetAssertion *response, std::unique_ptr<CBOR> &cbor)
+            Status encode(const GetAssertion *response, Encoder &encoder)
             {
-                // use external buffer?
-                std::unique_ptr<CBORPair> cborPair(new CBORPair());
+                RETURN_IF_ERROR(encoder.writeMap(3));
 
                 // credential (0x01)
+                // the platform has to learn which credential of the allowList was used
+                RETURN_IF_ERROR(encoder.writeInt(0x01));
+                RETURN_IF_ERROR(encoder.writeMap(2));
+                RETURN_IF_ERROR(encoder.writeText("id"));
+                RETURN_IF_ERROR(encoder.writeBytes(response->credential.credentialId.data, response->credential.credentialId.length));
+                RETURN_IF_ERROR(encoder.writeText("type"));
+                RETURN_IF_ERROR(encoder.writeText("public-key"));
 
                 // authData (0x02)
-                CBOR cborAuthData;
-                cborAuthData.encode((uint8_t*)&response->authenticatorData, sizeof(AuthenticatorData) - sizeof(AttestedCredentialData));
-                cborPair->append(0x02, cborAuthData);
+                RETURN_IF_ERROR(encoder.writeInt(0x02));
+                RETURN_IF_ERROR(encoder.writeBytes((const uint8_t *)&response->authenticatorData, sizeof(AuthenticatorData) - sizeof(AttestedCredentialData)));
 
                 // signature (0x03)
-                CBOR cborSignature;
-                cborSignature.encode(response->signature, response->signatureSize);
-                cborPair->append(0x03, cborSignature);
+                RETURN_IF_ERROR(encoder.writeInt(0x03));
+                RETURN_IF_ERROR(encoder.writeBytes(response->signature, response->signatureSize));
 
                 // user (0x04)
 
@@ -208,9 +85,6 @@ namespace FIDO2
 
                 // userSelected (0x06)
 
-                // finalize the encoding
-                cbor = std::unique_ptr<CBOR>(new CBOR(*cborPair));
-
                 return CTAP2_OK;
             }
 
@@ -1,9 +1,5 @@
-#include <memory>
-
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "fido2/ctap/ctap.h"
 #include "util/util.h"
 
@@ -18,9 +14,13 @@ namespace FIDO2
                 return authenticatorGetInfo;
             }
 
-            Status parseGetInfo(const CBOR &cbor, std::unique_ptr<Command> &request)
+            Status parseGetInfo(Decoder &decoder, Arena &arena, Command **request)
             {
-                request = std::unique_ptr<GetInfo>(new GetInfo());
+                *request = arena.create<GetInfo>();
+                if (*request == nullptr)
+                {
+                    RETURN_ERROR(CTAP2_ERR_REQUEST_TOO_LARGE);
+                }
 
                 return CTAP2_OK;
             }
@@ -33,91 +33,123 @@ namespace FIDO2
                 return authenticatorGetInfo;
             }
 
-            Status encode(const GetInfo *response, std::unique_ptr<CBOR> &cbor)
+            /**
+             * The encoding is built once by the authenticator, the clientPin option is the only value
+             * which changes afterwards
+             */
+            Status encode(const GetInfo *response, Encoder &encoder)
             {
-                // use external buffer?
-                std::unique_ptr<CBORPair> cborPair(new CBORPair());
+                if (response->clientPinPosition == 0)
+                {
+                    return encoder.writeRaw(response->encoded.data, response->encoded.length);
+                }
+
+                const size_t position = response->clientPinPosition;
+                RETURN_IF_ERROR(encoder.writeRaw(response->encoded.data, position));
+                RETURN_IF_ERROR(encoder.writeBool(response->clientPin));
+                RETURN_IF_ERROR(encoder.writeRaw(response->encoded.data + position + 1, response->encoded.length - position - 1));
+
+                return CTAP2_OK;
+            }
+
+            Status encodeInfo(const Info *response, Encoder &encoder, size_t *clientPinPosition)
+            {
+                *clientPinPosition = 0;
+
+                const size_t count = 6 +
+                                     (response->versions.size() > 0) +
+                                     (response->extensions.size() > 0) +
+                                     (response->maxMsgSize != 0) +
+                                     (response->pinUvAuthProtocols.size() > 0);
+
+                RETURN_IF_ERROR(encoder.writeMap(count));
 
                 // List of supported versions.
                 if (response->versions.size() > 0)
                 {
-                    CBORArray versions = CBORArray();
+                    RETURN_IF_ERROR(encoder.writeInt(0x01));
+                    RETURN_IF_ERROR(encoder.writeArray(response->versions.size()));
                     for (auto it = response->versions.begin(); it != response->versions.end(); it++)
                     {
-                        versions.append((*it).c_str());
+                        RETURN_IF_ERROR(encoder.writeText((*it).c_str()));
                     }
-                    cborPair->append(0x01, versions);
                 }
 
                 // // List of supported extensions
                 if (response->extensions.size() > 0)
                 {
-                    CBORArray extensions = CBORArray();
+                    RETURN_IF_ERROR(encoder.writeInt(0x02));
+                    RETURN_IF_ERROR(encoder.writeArray(response->extensions.size()));
                     for (auto it = response->extensions.begin(); it != response->extensions.end(); it++)
                     {
-                        extensions.append((*it).c_str());
+                        RETURN_IF_ERROR(encoder.writeText((*it).c_str()));
                     }
-                    cborPair->append(0x02, extensions);
                 }
 
                 // AAGUID
-                CBOR cbor_aaguid;
-                cbor_aaguid.encode(response->aaguid.get_bytes(), 16);
-                cborPair->append(0x03, cbor_aaguid);
-
-                // Map of options
-                CBORPair options = CBORPair();
-                if (response->options.clientPinSupported)
+                RETURN_IF_ERROR(encoder.writeInt(0x03));
+                RETURN_IF_ERROR(encoder.writeBytes(response->aaguid.get_bytes(), 16));
+
+                // Map of options, the keys are sorted by length and then lexically
+                RETURN_IF_ERROR(encoder.writeInt(0x04));
+                RETURN_IF_ERROR(encoder.writeMap(3 + response->options.uvSupported + response->options.clientPinSupported));
+                RETURN_IF_ERROR(encoder.writeText("rk"));
+                RETURN_IF_ERROR(encoder.writeBool(response->options.rk));
+                RETURN_IF_ERROR(encoder.writeText("up"));
+                RETURN_IF_ERROR(encoder.writeBool(response->options.up));
+                if (response->options.uvSupported)
                 {
-                    options.append("clientPin", response->options.clientPin);
+                    RETURN_IF_ERROR(encoder.writeText("uv"));
+                    RETURN_IF_ERROR(encoder.writeBool(response->options.uv));
                 }
-                options.append("plat", response->options.plat);
-                options.append("rk", response->options.rk);
-                options.append("up", response->options.up);
-                if (response->options.uvSupported)
+                RETURN_IF_ERROR(encoder.writeText("plat"));
+                RETURN_IF_ERROR(encoder.writeBool(response->options.plat));
+                if (response->options.clientPinSupported)
                 {
-                    options.append("uv", response->options.uv);
+                    RETURN_IF_ERROR(encoder.writeText("clientPin"));
+                    *clientPinPosition = encoder.getLength();
+                    RETURN_IF_ERROR(encoder.writeBool(response->options.clientPin));
                 }
-                cborPair->append(0x04, options);
 
                 // max msg size
-                if (response->maxMsgSize != nullptr)
+                if (response->maxMsgSize != 0)
                 {
-                    cborPair->append(0x05, *response->maxMsgSize);
+                    RETURN_IF_ERROR(encoder.writeInt(0x05));
+                    RETURN_IF_ERROR(encoder.writeInt(response->maxMsgSize));
                 }
 
                 // List of supported PIN/UV protocol versions.
-                if (response->options.clientPinSupported)
+                if (response->pinUvAuthProtocols.size() > 0)
                 {
-                    CBORArray cborVersions;
-                    cborVersions.append((uint8_t)0x01);
-                    cborPair->append(0x06, cborVersions);
+                    RETURN_IF_ERROR(encoder.writeInt(0x06));
+                    RETURN_IF_ERROR(encoder.writeArray(response->pinUvAuthProtocols.size()));
+                    for (auto it = response->pinUvAuthProtocols.begin(); it != response->pinUvAuthProtocols.end(); it++)
+                    {
+                        RETURN_IF_ERROR(encoder.writeInt(*it));
+                    }
                 }
 
                 // Maximum number of credentials supported in credentialID list at a time by the authenticator.
-                cborPair->append(0x07, (uint8_t)8);
+                RETURN_IF_ERROR(encoder.writeInt(0x07));
+                RETURN_IF_ERROR(encoder.writeInt(8));
 
                 // maxCredentialIdLength
-                cborPair->append(0x08, (uint8_t)16);
+                RETURN_IF_ERROR(encoder.writeInt(0x08));
+                RETURN_IF_ERROR(encoder.writeInt(CREDENTIAL_ID_LENGTH));
 
                 // List of supported transports
-                CBORArray cborTransports;
-                cborTransports.append("ble");
-                cborPair->append(0x09, cborTransports);
+                RETURN_IF_ERROR(encoder.writeInt(0x09));
+                RETURN_IF_ERROR(encoder.writeArray(1));
+                RETURN_IF_ERROR(encoder.writeText("ble"));
 
                 // List of supported algorithms for credential generation.
-                CBORArray cborAlgorithms;
-
-                CBORPair cborAlgorithm;
-                cborAlgorithm.append("alg", -7);
-                cborAlgorithm.append("type", "public-key");
-
-                cborAlgorithms.append(cborAlgorithm);
-
-                cborPair->append(0x0A, cborAlgorithms);
-
-                // finalize the encoding
-                cbor = std::unique_ptr<CBOR>(new CBOR(*cborPair));
+                RETURN_IF_ERROR(encoder.writeInt(0x0A));
+                RETURN_IF_ERROR(encoder.writeArray(1));
+                RETURN_IF_ERROR(encoder.writeMap(2));
+                RETURN_IF_ERROR(encoder.writeText("alg"));
+                RETURN_IF_ERROR(encoder.writeInt(-7));
+                RETURN_IF_ERROR(encoder.writeText("type"));
+                RETURN_IF_ERROR(encoder.writeText("public-key"));
 
                 return CTAP2_OK;
             }
@@ -1,7 +1,5 @@
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "fido2/ctap/ctap.h"
 #include "util/util.h"
 
@@ -16,9 +14,13 @@ namespace FIDO2
                 return authenticatorReset;
             }
 
-            Status parseReset(const CBOR &cbor, std::unique_ptr<Command> &request)
+            Status parseReset(Decoder &decoder, Arena &arena, Command **request)
             {
-                request = std::unique_ptr<Reset>(new Reset());
+                *request = arena.create<Reset>();
+                if (*request == nullptr)
+                {
+                    RETURN_ERROR(CTAP2_ERR_REQUEST_TOO_LARGE);
+                }
 
                 return CTAP2_OK;
             }
@@ -31,7 +33,7 @@ namespace FIDO2
                 return authenticatorReset;
             }
 
-            Status encode(const Reset *response, std::unique_ptr<CBOR> &cbor)
+            Status encode(const Reset *response, Encoder &encoder)
             {
                 return CTAP2_OK;
             }
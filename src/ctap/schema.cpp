@@ -0,0 +1,42 @@
+#include <Arduino.h>
+
+#include "fido2/ctap/schema.h"
+
+namespace FIDO2
+{
+    namespace CTAP
+    {
+        namespace Request
+        {
+            Status validateField(const Decoder &decoder, const Decoder::MajorType type, const uint32_t maxLength)
+            {
+                Decoder::MajorType actual;
+                uint64_t argument;
+                RETURN_IF_ERROR(decoder.peekHeader(actual, argument));
+
+                if (actual != type)
+                {
+                    RETURN_ERROR(CTAP2_ERR_CBOR_UNEXPECTED_TYPE);
+                }
+
+                if (maxLength == 0 || argument <= maxLength)
+                {
+                    return CTAP2_OK;
+                }
+
+                switch (type)
+                {
+                case Decoder::TYPE_UNSIGNED:
+                    RETURN_ERROR(CTAP1_ERR_INVALID_PARAMETER);
+                case Decoder::TYPE_BYTES:
+                case Decoder::TYPE_TEXT:
+                case Decoder::TYPE_ARRAY:
+                case Decoder::TYPE_MAP:
+                    RETURN_ERROR(CTAP1_ERR_INVALID_LENGTH);
+                default:
+                    return CTAP2_OK;
+                }
+            }
+        } // namespace Request
+    }     // namespace CTAP
+} // namespace FIDO2
\ No newline at end of file
@@ -1,5 +1,3 @@
-#include <memory>
-
 #include <Arduino.h>
 
 #include "fido2/authenticator/authenticator.h"
@@ -86,6 +84,8 @@ namespace FIDO2
 
         void reset()
         {
+            // invalidates all the credentials created so far
+            resetMasterKey();
         }
 
         void powerUp()
@@ -95,6 +95,8 @@ namespace FIDO2
             esp_fill_random(agreementKey.key, 32);
 
             esp_fill_random(pinUvAuthToken, 16);
+
+            loadMasterKey();
         }
 
         static Status status = STATUS_IDLE;
@@ -109,32 +111,50 @@ namespace FIDO2
             status = _status;
         }
 
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Command *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Command *request, Arena &arena, FIDO2::CTAP::Command **response, const CancellationToken &token)
         {
+            // cancelled while waiting in the queue
+            if (token.isCancelled())
+            {
+                return FIDO2::CTAP::CTAP2_ERR_KEEPALIVE_CANCEL;
+            }
+
             status = STATUS_PROCESSING;
 
             Display::enableIcon(ICON_PROCESSING);
 
             FIDO2::CTAP::Status ret = FIDO2::CTAP::CTAP1_ERR_INVALID_COMMAND;
-            switch (request->getCommandCode())
             {
-            case FIDO2::CTAP::authenticatorGetInfo:
-                ret = processRequest(static_cast<const FIDO2::CTAP::Request::GetInfo *>(request), response);
-                break;
-            case FIDO2::CTAP::authenticatorGetAssertion:
-                ret = processRequest((const FIDO2::CTAP::Request::GetAssertion *)request, response);
-                break;
-            case FIDO2::CTAP::authenticatorMakeCredential:
-                ret = processRequest((const FIDO2::CTAP::Request::MakeCredential *)request, response);
-                break;
-            case FIDO2::CTAP::authenticatorClientPIN:
-                ret = processRequest((const FIDO2::CTAP::Request::ClientPIN *)request, response);
-                break;
-            case FIDO2::CTAP::authenticatorReset:
-                ret = processRequest((const FIDO2::CTAP::Request::Reset *)request, response);
-                break;
-            default:
-                break;
+                // the secure element stays awake until the command is processed
+                Crypto::Session session;
+
+                switch (request->getCommandCode())
+                {
+                case FIDO2::CTAP::authenticatorGetInfo:
+                    ret = processRequest(static_cast<const FIDO2::CTAP::Request::GetInfo *>(request), arena, response);
+                    break;
+                case FIDO2::CTAP::authenticatorGetAssertion:
+                    ret = processRequest((const FIDO2::CTAP::Request::GetAssertion *)request, arena, response);
+                    break;
+                case FIDO2::CTAP::authenticatorMakeCredential:
+                    ret = processRequest((const FIDO2::CTAP::Request::MakeCredential *)request, arena, response, token);
+                    break;
+                case FIDO2::CTAP::authenticatorClientPIN:
+                    ret = processRequest((const FIDO2::CTAP::Request::ClientPIN *)request, arena, response);
+                    break;
+                case FIDO2::CTAP::authenticatorReset:
+                    ret = processRequest((const FIDO2::CTAP::Request::Reset *)request, arena, response);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            const Crypto::Session::Stats &stats = Crypto::Session::getStats();
+            if (stats.commands > 0)
+            {
+                Serial.printf("# Secure element: %u commands, %u wake-ups, busy for %lu us within %lu us\n",
+                              stats.commands, stats.wakeUps, (unsigned long)stats.busy, (unsigned long)stats.duration);
             }
 
             Display::disableIcon(ICON_PROCESSING);
@@ -13,51 +13,41 @@ namespace FIDO2
         uint8_t pinUvAuthToken[16] = {};
 
         // getPINRetries 0x01
-        FIDO2::CTAP::Status cmdGetPinRetries(std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdGetPinRetries(FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("### Get PIN retries");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
             //
-            resp->pinRetries = std::unique_ptr<uint8_t>(new uint8_t(pinRetries));
+            resp->present.pinRetries = true;
+            resp->pinRetries = pinRetries;
 
             //
             if (pinRetries == 0)
             {
-                resp->powerCycleState = std::unique_ptr<bool>(new bool(true));
+                resp->present.powerCycleState = true;
+                resp->powerCycleState = true;
             }
 
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
-
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // getKeyAgreement	0x02
-        FIDO2::CTAP::Status cmdGetKeyAgreement(std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdGetKeyAgreement(FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("### Get Key Agreement");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
-            //
-            resp->publicKey = std::unique_ptr<Crypto::ECDSA::PublicKey>(new Crypto::ECDSA::PublicKey());
-            Crypto::ECDSA::derivePublicKey(&agreementKey, resp->publicKey.get());
-
             //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            resp->present.publicKey = true;
+            Crypto::ECDSA::derivePublicKey(&agreementKey, &resp->publicKey);
 
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // setPIN	0x03
-        FIDO2::CTAP::Status cmdSetPin(const FIDO2::CTAP::Request::ClientPIN *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdSetPin(const FIDO2::CTAP::Request::ClientPIN *request, FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("### Set PIN");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
             // If Authenticator does not receive mandatory parameters for this command, it returns CTAP2_ERR_MISSING_PARAMETER error.
 
             // If a PIN has already been set, authenticator returns CTAP2_ERR_PIN_AUTH_INVALID error.
@@ -77,19 +67,14 @@ namespace FIDO2
             pinIsSet = 1;
             pinRetries = maxRetries;
 
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
-
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // changePIN	0x04
-        FIDO2::CTAP::Status cmdChangePin(const FIDO2::CTAP::Request::ClientPIN *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdChangePin(const FIDO2::CTAP::Request::ClientPIN *request, FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("### Change PIN");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
             // Authenticator generates "sharedSecret"
             // SHA-256((abG).x) using private key of authenticatorKeyAgreementKey, "a" and public key of platformKeyAgreementKey, "bG".
             // SHA-256 is done over only "x" curve point of "abG"
@@ -107,80 +92,70 @@ namespace FIDO2
 
             // Authenticator generates a new pinToken.
 
-            // resp->pinUvAuthToken = std::unique_ptr<FixedBuffer16>(new FixedBuffer16());
+            // resp->present.pinUvAuthToken = true;
 
             pinIsSet = 1;
             pinRetries = maxRetries;
 
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
-
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // getPinUvAuthTokenUsingPin	0x05
-        FIDO2::CTAP::Status cmdGetPinUvAuthTokenUsingPin(std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdGetPinUvAuthTokenUsingPin(FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("Get PIN UV Auth token using PIN");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
-            resp->pinUvAuthToken = std::unique_ptr<FixedBuffer16>(new FixedBuffer16());
-
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            resp->present.pinUvAuthToken = true;
 
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // getPinUvAuthTokenUsingUv	0x06
-        FIDO2::CTAP::Status cmdGetPinUvAuthTokenUsingUv(std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdGetPinUvAuthTokenUsingUv(FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("Get PIN UV Auth token using UV");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
-            resp->pinUvAuthToken = std::unique_ptr<FixedBuffer16>(new FixedBuffer16());
-
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            resp->present.pinUvAuthToken = true;
 
             return FIDO2::CTAP::CTAP2_OK;
         }
 
         // getUVRetries	0x07
-        FIDO2::CTAP::Status cmdGetUVRetries(std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status cmdGetUVRetries(FIDO2::CTAP::Response::ClientPIN *resp)
         {
             Serial.println("Get UV retries");
 
-            std::unique_ptr<FIDO2::CTAP::Response::ClientPIN> resp = std::unique_ptr<FIDO2::CTAP::Response::ClientPIN>(new FIDO2::CTAP::Response::ClientPIN());
-
-            //
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
-
             return FIDO2::CTAP::CTAP2_OK;
         }
 
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::ClientPIN *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::ClientPIN *request, Arena &arena, FIDO2::CTAP::Command **response)
         {
             Serial.println("## ClientPIN");
 
+            // the subcommands fill in the parameters they return
+            FIDO2::CTAP::Response::ClientPIN *resp = arena.create<FIDO2::CTAP::Response::ClientPIN>();
+            if (resp == nullptr)
+            {
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
+            }
+            *response = resp;
+
             switch (request->subCommand)
             {
             case FIDO2::CTAP::Request::ClientPIN::cmdGetPINRetries:
-                return cmdGetPinRetries(response);
+                return cmdGetPinRetries(resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdGetKeyAgreement:
-                return cmdGetKeyAgreement(response);
+                return cmdGetKeyAgreement(resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdSetPIN:
-                return cmdSetPin(request, response);
+                return cmdSetPin(request, resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdChangePIN:
-                return cmdChangePin(request, response);
+                return cmdChangePin(request, resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdGetPinUvAuthTokenUsingPin:
-                return cmdGetPinUvAuthTokenUsingPin(response);
+                return cmdGetPinUvAuthTokenUsingPin(resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdGetPinUvAuthTokenUsingUv:
-                return cmdGetPinUvAuthTokenUsingUv(response);
+                return cmdGetPinUvAuthTokenUsingUv(resp);
             case FIDO2::CTAP::Request::ClientPIN::cmdGetUVRetries:
-                return cmdGetUVRetries(response);
+                return cmdGetUVRetries(resp);
             default:
                 break;
             }
@@ -11,39 +11,39 @@ namespace FIDO2
 {
     namespace Authenticator
     {
-        void sign(const FIDO2::CTAP::AuthenticatorData *authenticatorData, const uint8_t *clientDataHash, uint8_t *signature, size_t *signatureSize)
+        FIDO2::CTAP::Status sign(const FIDO2::CTAP::AuthenticatorData *authenticatorData, const uint8_t *clientDataHash, const Crypto::ECDSA::PrivateKey *privateKey, uint8_t *signature, size_t *signatureSize)
         {
             const size_t AuthDataWithAttSize = sizeof(FIDO2::CTAP::AuthenticatorData);
             const size_t AuthDataNoAttSize = sizeof(FIDO2::CTAP::AuthenticatorData) - sizeof(FIDO2::CTAP::AttestedCredentialData);
 
-            // construct data for signing
-            uint8_t buffer[AuthDataWithAttSize + 32];
-            size_t bufferSize;
-            if (authenticatorData->flags.f.attestationData)
-            {
-                memcpy(buffer, authenticatorData, AuthDataWithAttSize);
-                memcpy(buffer + AuthDataWithAttSize, clientDataHash, 32);
+            // the signed data is authenticatorData || clientDataHash, hashed in place
+            Crypto::SHA256::Context sha256;
+            sha256.init();
+            sha256.update((const uint8_t *)authenticatorData, authenticatorData->flags.f.attestationData ? AuthDataWithAttSize : AuthDataNoAttSize);
+            sha256.update(clientDataHash, 32);
 
-                bufferSize = AuthDataWithAttSize + 32;
-            }
-            else
+            uint8_t hash[32];
+            if (!sha256.finalize(hash))
             {
-                memcpy(buffer, authenticatorData, AuthDataNoAttSize);
-                memcpy(buffer + AuthDataNoAttSize, clientDataHash, 32);
-
-                bufferSize = AuthDataNoAttSize + 32;
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
             }
 
-            //
-            uint8_t hash[32];
-            Crypto::SHA256::hash(buffer, bufferSize, hash);
-
             Serial.println("Hash:");
             serialDumpBuffer(hash, 32);
 
             //
             uint8_t signatureBuf[64];
-            Crypto::ECDSA::sign(hash, signatureBuf);
+            if (privateKey != nullptr)
+            {
+                if (!Crypto::ECDSA::sign(privateKey, hash, signatureBuf))
+                {
+                    return FIDO2::CTAP::CTAP1_ERR_OTHER;
+                }
+            }
+            else
+            {
+                Crypto::ECDSA::sign(hash, signatureBuf);
+            }
 
             Serial.println("Signature:");
             serialDumpBuffer(signatureBuf, 64);
@@ -54,6 +54,8 @@ namespace FIDO2
             Serial.println("Encoded signature:");
             serialDumpBuffer(signature, *signatureSize);
             Serial.printf("%d\n", *signatureSize);
+
+            return FIDO2::CTAP::CTAP2_OK;
         }
 
     }
@@ -0,0 +1,114 @@
+#include <Arduino.h>
+
+#include <AES.h>
+#include <CTR.h>
+#include <Crypto.h>
+#include <Preferences.h>
+#include <SHA256.h>
+
+#include "config.h"
+
+#include "fido2/authenticator/authenticator.h"
+
+// NVS namespace and key of the master key
+#define MASTER_KEY_NAMESPACE "fido2"
+#define MASTER_KEY_NAME "master"
+
+// layout of the credential ID
+#define IV_SIZE 16
+#define WRAPPED_KEY_SIZE 32
+#define MAC_SIZE 16
+
+namespace FIDO2
+{
+    namespace Authenticator
+    {
+        static_assert(CREDENTIAL_ID_LENGTH == IV_SIZE + WRAPPED_KEY_SIZE + MAC_SIZE, "credential ID length does not match the wrapped key");
+
+        /**
+         * Device master key, the first half encrypts the credential keys and the second half authenticates
+         * the credential IDs
+         */
+        static struct
+        {
+            uint8_t encryption[32];
+            uint8_t authentication[32];
+        } masterKey;
+
+        void loadMasterKey()
+        {
+            Preferences preferences;
+            preferences.begin(MASTER_KEY_NAMESPACE, false);
+
+            if (preferences.getBytes(MASTER_KEY_NAME, &masterKey, sizeof(masterKey)) != sizeof(masterKey))
+            {
+                Serial.println("Generating the master key");
+
+                esp_fill_random(&masterKey, sizeof(masterKey));
+                preferences.putBytes(MASTER_KEY_NAME, &masterKey, sizeof(masterKey));
+            }
+
+            preferences.end();
+        }
+
+        void resetMasterKey()
+        {
+            Preferences preferences;
+            preferences.begin(MASTER_KEY_NAMESPACE, false);
+            preferences.remove(MASTER_KEY_NAME);
+            preferences.end();
+
+            loadMasterKey();
+        }
+
+        /**
+         * MAC of the IV and the encrypted key, bound to the RP the credential was created for
+         */
+        static void authenticate(const uint8_t *rpIdHash, const uint8_t *credentialId, uint8_t *mac)
+        {
+            ::SHA256 sha256;
+
+            sha256.resetHMAC(masterKey.authentication, sizeof(masterKey.authentication));
+            sha256.update(credentialId, IV_SIZE + WRAPPED_KEY_SIZE);
+            sha256.update(rpIdHash, 32);
+            sha256.finalizeHMAC(masterKey.authentication, sizeof(masterKey.authentication), mac, MAC_SIZE);
+        }
+
+        static void encrypt(const uint8_t *iv, const uint8_t *input, uint8_t *output)
+        {
+            CTR<AES256> ctr;
+
+            ctr.setKey(masterKey.encryption, sizeof(masterKey.encryption));
+            ctr.setIV(iv, IV_SIZE);
+            ctr.encrypt(output, input, WRAPPED_KEY_SIZE);
+            ctr.clear();
+        }
+
+        void wrapKey(const uint8_t *rpIdHash, const Crypto::ECDSA::PrivateKey *privateKey, uint8_t *credentialId)
+        {
+            esp_fill_random(credentialId, IV_SIZE);
+            encrypt(credentialId, privateKey->key, credentialId + IV_SIZE);
+            authenticate(rpIdHash, credentialId, credentialId + IV_SIZE + WRAPPED_KEY_SIZE);
+        }
+
+        bool unwrapKey(const uint8_t *rpIdHash, const ByteView &credentialId, Crypto::ECDSA::PrivateKey *privateKey)
+        {
+            if (credentialId.length != CREDENTIAL_ID_LENGTH)
+            {
+                return false;
+            }
+
+            // IDs of other authenticators and of other RPs are rejected before anything is decrypted
+            uint8_t mac[MAC_SIZE];
+            authenticate(rpIdHash, credentialId.data, mac);
+            if (!secure_compare(mac, credentialId.data + IV_SIZE + WRAPPED_KEY_SIZE, MAC_SIZE))
+            {
+                return false;
+            }
+
+            encrypt(credentialId.data, credentialId.data + IV_SIZE, privateKey->key);
+
+            return true;
+        }
+    } // namespace Authenticator
+} // namespace FIDO2
\ No newline at end of file
@@ -2,17 +2,25 @@
 
 #include "fido2/authenticator/authenticator.h"
 
+#include "cred-storage/storage.h"
+
 #include "crypto/crypto.h"
 
+#include "util/util.h"
+
 namespace FIDO2
 {
     namespace Authenticator
     {
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetAssertion *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetAssertion *request, Arena &arena, FIDO2::CTAP::Command **response)
         {
             Serial.println("## GetAssertion");
 
-            std::unique_ptr<FIDO2::CTAP::Response::GetAssertion> resp = std::unique_ptr<FIDO2::CTAP::Response::GetAssertion>(new FIDO2::CTAP::Response::GetAssertion());
+            FIDO2::CTAP::Response::GetAssertion *resp = arena.create<FIDO2::CTAP::Response::GetAssertion>();
+            if (resp == nullptr)
+            {
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
+            }
 
             // 1. If authenticator supports clientPin and platform sends a zero length pinUvAuthParam,
             // wait for user touch and then return either CTAP2_ERR_PIN_NOT_SET if pin is not set or
@@ -37,15 +45,48 @@ namespace FIDO2
 
             // 6. If authenticator is protected by some form of user verification: ...
 
-            // 7. Locate all credentials that are eligible for retrieval under the specified criteria:
-
-            // 8. Collect user presence if required: ...
+            Crypto::SHA256::hash((const uint8_t *)request->rpId.data, request->rpId.length, resp->authenticatorData.rpIdHash);
 
-            // 9. If allowList is present: ...
-
-            // 10. If allowlist is not present: ...
-
-            Crypto::SHA256::hash((uint8_t *)request->rpId.c_str(), request->rpId.length(), resp->authenticatorData.rpIdHash);
+            // 7. Locate all credentials that are eligible for retrieval under the specified criteria:
+            //    * If an allowList is present and is non-empty, locate all denoted credentials present on this
+            //      authenticator and bound to the specified rpId.
+            //    * If an allowList is not present, locate all credentials that are present on this authenticator
+            //      and bound to the specified rpId.
+            // The key of a credential is recovered from its ID, only the resident credentials are looked up in the storage.
+            Crypto::ECDSA::PrivateKey privateKey;
+            bool found = false;
+
+            FIDO2::CTAP::PublicKeyCredentialDescriptor descriptor;
+            for (auto reader = request->allowList.read(); !found && reader.next(descriptor);)
+            {
+                if (unwrapKey(resp->authenticatorData.rpIdHash, descriptor.credentialId, &privateKey))
+                {
+                    resp->credential = descriptor;
+                    found = true;
+                }
+            }
+
+            if (!request->allowList.isPresent())
+            {
+                String rpId;
+                request->rpId.toString(rpId);
+
+                CredentialsStorage::Credential *credential;
+                if (CredentialsStorage::findCredential(rpId, &credential))
+                {
+                    resp->credential.credentialId.data = credential->id;
+                    resp->credential.credentialId.length = CREDENTIAL_ID_LENGTH;
+                    found = unwrapKey(resp->authenticatorData.rpIdHash, resp->credential.credentialId, &privateKey);
+                }
+            }
+
+            // 8. If no credentials were located in step 7, return CTAP2_ERR_NO_CREDENTIALS.
+            if (!found)
+            {
+                RETURN_ERROR(FIDO2::CTAP::CTAP2_ERR_NO_CREDENTIALS);
+            }
+
+            // 9. Collect user presence if required: ...
 
             resp->authenticatorData.signCount = 0;
 
@@ -53,9 +94,9 @@ namespace FIDO2
             resp->authenticatorData.flags.f.userVerified = true;
 
             // sign
-            sign(&resp->authenticatorData, request->clientDataHash, resp->signature, &resp->signatureSize);
+            RETURN_IF_ERROR(sign(&resp->authenticatorData, request->clientDataHash, &privateKey, resp->signature, &resp->signatureSize));
 
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            *response = resp;
 
             // return response;
             return FIDO2::CTAP::CTAP2_OK;
@@ -1,51 +1,94 @@
-#include <memory>
-
 #include <Arduino.h>
 
 #include "config.h"
 
 #include "fido2/authenticator/authenticator.h"
 
+// size of the encoded authenticatorGetInfo parameters
+#define INFO_BUFFER_SIZE 256
+
 namespace FIDO2
 {
     namespace Authenticator
     {
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetInfo *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
-        {
-            Serial.println("## GetInfo");
+        static uint8_t infoBuffer[INFO_BUFFER_SIZE];
+        static size_t infoLength = 0;
+        static size_t clientPinPosition = 0;
 
-            std::unique_ptr<FIDO2::CTAP::Response::GetInfo> resp = std::unique_ptr<FIDO2::CTAP::Response::GetInfo>(new FIDO2::CTAP::Response::GetInfo());
+        /**
+         * Encode the parts of the response which do not change while the authenticator runs
+         */
+        static FIDO2::CTAP::Status buildInfo()
+        {
+            FIDO2::CTAP::Response::Info info;
 
             // List of supported versions. Supported versions are: "FIDO_2_0" for CTAP2 / FIDO2 / Web Authentication authenticators
             // and "U2F_V2" for CTAP1/U2F authenticators.
-            resp->versions.push_back("FIDO_2_0");
-            // resp->versions.push_back("FIDO_2_1_PRE");
-            // resp->versions.push_back("FIDO_2_1");
+            info.versions.push_back("FIDO_2_0");
+            // info.versions.push_back("FIDO_2_1_PRE");
+            // info.versions.push_back("FIDO_2_1");
 
             // List of supported extensions
-            resp->extensions.push_back("hmac-secret");
-            // resp->extensions.push_back("credProtect");
+            info.extensions.push_back("hmac-secret");
+            // info.extensions.push_back("credProtect");
 
             // The claimed AAGUID. 16 bytes in length and encoded the same as MakeCredential AuthenticatorData, as specified in [WebAuthn]
-            resp->aaguid = FIDO2::Authenticator::aaguid;
+            info.aaguid = FIDO2::Authenticator::aaguid;
 
             //List of supported options.
-            resp->options.plat = false;
-            resp->options.rk = true;
-            resp->options.clientPinSupported = true;
-            resp->options.clientPin = pinIsSet ? true : false;
-            resp->options.up = false;
-            resp->options.uvSupported = true;
-            resp->options.uv = true;
+            info.options.plat = false;
+            info.options.rk = true;
+            info.options.clientPinSupported = true;
+            // patched in every response
+            info.options.clientPin = false;
+            info.options.up = false;
+            info.options.uvSupported = true;
+            info.options.uv = true;
 
             // Maximum message size supported by the authenticator.
-            resp->maxMsgSize = std::unique_ptr<uint16_t>(new uint16_t(2048));
+            info.maxMsgSize = 2048;
 
             // List of supported PIN/UV protocol versions.
-            resp->pinUvAuthProtocols = std::unique_ptr<std::vector<uint8_t>>(new std::vector<uint8_t>());
-            resp->pinUvAuthProtocols->push_back(1);
+            info.pinUvAuthProtocols.push_back(1);
+
+            FIDO2::CTAP::Encoder encoder(infoBuffer, sizeof(infoBuffer));
+            FIDO2::CTAP::Status status = FIDO2::CTAP::Response::encodeInfo(&info, encoder, &clientPinPosition);
+            if (status != FIDO2::CTAP::CTAP2_OK)
+            {
+                return status;
+            }
+
+            infoLength = encoder.getLength();
+
+            return FIDO2::CTAP::CTAP2_OK;
+        }
+
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::GetInfo *request, Arena &arena, FIDO2::CTAP::Command **response)
+        {
+            Serial.println("## GetInfo");
+
+            // the response is encoded on first use and served from the buffer afterwards
+            if (infoLength == 0)
+            {
+                FIDO2::CTAP::Status status = buildInfo();
+                if (status != FIDO2::CTAP::CTAP2_OK)
+                {
+                    return status;
+                }
+            }
+
+            FIDO2::CTAP::Response::GetInfo *resp = arena.create<FIDO2::CTAP::Response::GetInfo>();
+            if (resp == nullptr)
+            {
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
+            }
+
+            resp->encoded.data = infoBuffer;
+            resp->encoded.length = infoLength;
+            resp->clientPinPosition = clientPinPosition;
+            resp->clientPin = pinIsSet ? true : false;
 
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            *response = resp;
 
             return FIDO2::CTAP::CTAP2_OK;
         }
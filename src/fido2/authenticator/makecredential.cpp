@@ -1,7 +1,5 @@
 #include <Arduino.h>
 
-#include <YACL.h>
-
 #include "display/display.h"
 #include "keyboard/keyboard.h"
 
@@ -23,28 +21,30 @@ namespace FIDO2
             Serial.println("## MakeCredential");
             Serial.printf(" * ClientDataHash\n");
             serialDumpBuffer(request->clientDataHash, 32);
-            Serial.printf(" * RP id: %s\n", request->rp.id.c_str());
-            Serial.printf(" * RP name: %s\n", request->rp.name.c_str());
+            Serial.printf(" * RP id: %.*s\n", (int)request->rp.id.length, request->rp.id.data);
+            Serial.printf(" * RP name: %.*s\n", (int)request->rp.name.length, request->rp.name.data);
             Serial.printf(" * User id:\n");
-            serialDumpBuffer(request->user.id.value, request->user.id.length);
-            Serial.printf(" * User name: %s\n", request->user.name.c_str());
-            Serial.printf(" * User display name: %s\n", request->user.displayName.c_str());
+            serialDumpBuffer(request->user.id.data, request->user.id.length);
+            Serial.printf(" * User name: %.*s\n", (int)request->user.name.length, request->user.name.data);
+            Serial.printf(" * User display name: %.*s\n", (int)request->user.displayName.length, request->user.displayName.data);
             Serial.print(" * Algorithms: ");
-            for (auto it = request->algorithms.begin(); it != request->algorithms.end(); it++)
+            FIDO2::CTAP::PublicKeyCredentialParameters parameters;
+            for (auto reader = request->pubKeyCredParams.read(); reader.next(parameters);)
             {
-                Serial.printf("%d ", *it);
+                Serial.printf("%d ", parameters.alg);
             }
             Serial.println();
-            if (request->pinUvAuthParam)
+            if (request->pinUvAuthParam.isPresent())
             {
                 Serial.printf(" * pinUvAuthParam:\n");
-                serialDumpBuffer(request->pinUvAuthParam->value, request->pinUvAuthParam->length);
+                serialDumpBuffer(request->pinUvAuthParam.data, request->pinUvAuthParam.length);
             }
             Serial.printf(" * pinUvAuthProtocol: %d\n", request->pinUvAuthProtocol);
             Serial.println(" * Exclude list");
-            for (auto it = request->excludeList.begin(); it != request->excludeList.end(); it++)
+            FIDO2::CTAP::PublicKeyCredentialDescriptor descriptor;
+            for (auto reader = request->excludeList.read(); reader.next(descriptor);)
             {
-                serialDumpBuffer(it->credentialId.value, it->credentialId.length);
+                serialDumpBuffer(descriptor.credentialId.data, descriptor.credentialId.length);
             }
             Serial.println(" * Options");
             Serial.printf("  * rk: %d\n", request->options.rk);
@@ -52,22 +52,27 @@ namespace FIDO2
             Serial.printf("  * uv: %d\n", request->options.uv);
         }
 
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::MakeCredential *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::MakeCredential *request, Arena &arena, FIDO2::CTAP::Command **response, const CancellationToken &token)
         {
             serialDumpRequest(request);
 
             // 1. If authenticator supports clientPin and platform sends a zero length pinUvAuthParam,
             // wait for user touch and then return either CTAP2_ERR_PIN_NOT_SET if pin is not set
             // or CTAP2_ERR_PIN_INVALID if pin has been set.
-            if (request->pinUvAuthParam != nullptr && request->pinUvAuthParam->length == 0)
+            if (request->pinUvAuthParam.isPresent() && request->pinUvAuthParam.length == 0)
             {
                 //
                 Display::showText("Use this device?\nTouch Ok to confirm");
 
-                if (Keyboard::waitForTouch('\n', 30000))
+                if (Keyboard::waitForTouch('\n', 30000, &token))
                 {
                     return pinIsSet ? FIDO2::CTAP::CTAP2_ERR_PIN_INVALID : FIDO2::CTAP::CTAP2_ERR_PIN_NOT_SET;
                 }
+                else if (token.isCancelled())
+                {
+                    Display::showText("Canceled");
+                    return FIDO2::CTAP::CTAP2_ERR_KEEPALIVE_CANCEL;
+                }
                 else
                 {
                     return FIDO2::CTAP::CTAP2_ERR_ACTION_TIMEOUT;
@@ -81,9 +86,10 @@ namespace FIDO2
             // that is supported by the authenticator, terminate this procedure and return
             // error code CTAP2_ERR_UNSUPPORTED_ALGORITHM.
             bool hasSupportedAlgorithm = false;
-            for (auto it = request->algorithms.begin(); it != request->algorithms.end(); it++)
+            FIDO2::CTAP::PublicKeyCredentialParameters parameters;
+            for (auto reader = request->pubKeyCredParams.read(); reader.next(parameters);)
             {
-                if (*it == -7)
+                if (parameters.type.equals("public-key") && parameters.alg == -7)
                 {
                     hasSupportedAlgorithm = true;
                 }
@@ -91,7 +97,7 @@ namespace FIDO2
 
             if (!hasSupportedAlgorithm)
             {
-                RAISE(FIDO2::CTAP::Exception(FIDO2::CTAP::CTAP2_ERR_UNSUPPORTED_ALGORITHM));
+                RETURN_ERROR(FIDO2::CTAP::CTAP2_ERR_UNSUPPORTED_ALGORITHM);
             }
 
             // 4. If the options parameter is present, process all the options. If the option is known but not supported,
@@ -104,16 +110,20 @@ namespace FIDO2
             // Authenticator extension outputs generated by the authenticator extension processing are returned in the
             // authenticator data.
 
+            uint8_t rpIdHash[32];
+            Crypto::SHA256::hash((const uint8_t *)request->rp.id.data, request->rp.id.length, rpIdHash);
+
             // 6. If the excludeList parameter is present and contains a credential ID that is present on this
             // authenticator and bound to the specified rpId
             // ...
-            for (auto it = request->excludeList.begin(); it != request->excludeList.end(); it++)
+            // the credential IDs are authenticated with the RP ID hash, so no lookup in the storage is needed
+            FIDO2::CTAP::PublicKeyCredentialDescriptor descriptor;
+            for (auto reader = request->excludeList.read(); reader.next(descriptor);)
             {
-
-                CredentialsStorage::Credential *credential;
-                if (CredentialsStorage::getCredential(it->credentialId, &credential) && credential->rpId == request->rp.id)
+                Crypto::ECDSA::PrivateKey excludedKey;
+                if (unwrapKey(rpIdHash, descriptor.credentialId, &excludedKey))
                 {
-                    RAISE(CTAP::Exception(FIDO2::CTAP::CTAP2_ERR_CREDENTIAL_EXCLUDED));
+                    RETURN_ERROR(FIDO2::CTAP::CTAP2_ERR_CREDENTIAL_EXCLUDED);
                 }
             }
 
@@ -141,28 +151,38 @@ namespace FIDO2
             //
             {
                 char scrBuffer[100];
-                char rpid[20] = {};
-                strncpy(rpid, request->rp.name.c_str(), 19);
-                char uname[20] = {};
-                strncpy(uname, request->user.displayName.c_str(), 19);
+                char rpid[20];
+                request->rp.name.copyTo(rpid, sizeof(rpid));
+                char uname[20];
+                request->user.displayName.copyTo(uname, sizeof(uname));
                 sprintf(scrBuffer, "Create new?\n%s\n%s\nTouch Ok to confirm", rpid, uname);
                 Display::showText(scrBuffer);
 
-                if (!Keyboard::waitForTouch('\n', 30000))
+                if (!Keyboard::waitForTouch('\n', 30000, &token))
                 {
                     Display::showText("Canceled");
-                    RAISE(CTAP::Exception(FIDO2::CTAP::CTAP2_ERR_OPERATION_DENIED));
+                    if (token.isCancelled())
+                    {
+                        RETURN_ERROR(FIDO2::CTAP::CTAP2_ERR_KEEPALIVE_CANCEL);
+                    }
+                    RETURN_ERROR(FIDO2::CTAP::CTAP2_ERR_OPERATION_DENIED);
                 }
 
                 Display::showText("");
             }
 
             // 12. Generate a new credential key pair for the algorithm specified.
+            Crypto::ECDSA::PrivateKey privateKey;
+            Crypto::ECDSA::generatePrivateKey(&privateKey);
             Crypto::ECDSA::PublicKey publicKey;
-            Crypto::ECDSA::getPublicKey(&publicKey);
+            Crypto::ECDSA::derivePublicKey(&privateKey, &publicKey);
 
             //
-            std::unique_ptr<FIDO2::CTAP::Response::MakeCredential> resp = std::unique_ptr<FIDO2::CTAP::Response::MakeCredential>(new FIDO2::CTAP::Response::MakeCredential());
+            FIDO2::CTAP::Response::MakeCredential *resp = arena.create<FIDO2::CTAP::Response::MakeCredential>();
+            if (resp == nullptr)
+            {
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
+            }
 
             // aaguid
             memcpy(resp->authenticatorData.attestedCredentialData.aaguid, aaguid.get_bytes(), 16);
@@ -172,6 +192,16 @@ namespace FIDO2
             resp->authenticatorData.flags.f.userPresent = true;
             resp->authenticatorData.flags.f.userVerified = true;
 
+            memcpy(resp->authenticatorData.rpIdHash, rpIdHash, sizeof(rpIdHash));
+
+            // the credential ID is the wrapped private key
+            resp->authenticatorData.attestedCredentialData.credentialIdLen = CREDENTIAL_ID_LENGTH;
+            wrapKey(rpIdHash, &privateKey, resp->authenticatorData.attestedCredentialData.credentialId);
+
+            FIDO2::CTAP::Response::encodePublicKey(&publicKey, resp->authenticatorData.attestedCredentialData.publicKey);
+
+            resp->authenticatorData.flags.f.attestationData = true;
+
             // 13. If "rk" in options parameter is set to true:
             //    * If a credential for the same RP ID and account ID already exists on the authenticator,
             //      overwrite that credential.
@@ -180,30 +210,28 @@ namespace FIDO2
             //      return CTAP2_ERR_KEY_STORE_FULL.
             if (request->options.rk)
             {
+                // the stored credential owns copies of the identifiers
+                String rpId;
+                request->rp.id.toString(rpId);
+                FixedBuffer64 userId;
+                userId.alloc(request->user.id.length);
+                memcpy(userId.value, request->user.id.data, request->user.id.length);
+
                 CredentialsStorage::Credential* credential = nullptr;
-                if (!CredentialsStorage::findCredential(request->rp.id, request->user.id, &credential))
+                if (!CredentialsStorage::findCredential(rpId, userId, &credential))
                 {
-                    CredentialsStorage::createCredential(request->rp.id, request->user.id, &credential);
+                    CredentialsStorage::createCredential(rpId, userId, &credential);
                 }
 
-                // 14. Generate an attestation statement for the newly-created key using clientDataHash.
-
-                // save credential id
-                resp->authenticatorData.attestedCredentialData.credentialIdLen = CREDENTIAL_ID_LENGTH;
-                memcpy(resp->authenticatorData.attestedCredentialData.credentialId, credential->id.value, CREDENTIAL_ID_LENGTH);
-
-                FIDO2::CTAP::Response::encodePublicKey(&publicKey, resp->authenticatorData.attestedCredentialData.publicKey);
-
-                Crypto::SHA256::hash((const uint8_t *)request->rp.id.c_str(), request->rp.id.length(), resp->authenticatorData.rpIdHash);
-
-                resp->authenticatorData.flags.f.attestationData = true;
+                // an existing credential is overwritten with the new key
+                memcpy(credential->id, resp->authenticatorData.attestedCredentialData.credentialId, CREDENTIAL_ID_LENGTH);
             }
 
-            // sign
-            sign(&resp->authenticatorData, request->clientDataHash, resp->signature, &resp->signatureSize);
+            // 14. Generate an attestation statement for the newly-created key using clientDataHash.
+            RETURN_IF_ERROR(sign(&resp->authenticatorData, request->clientDataHash, nullptr, resp->signature, &resp->signatureSize));
 
             // finalize the response
-            response = std::unique_ptr<FIDO2::CTAP::Command>(resp.release());
+            *response = resp;
 
             // return response;
             return FIDO2::CTAP::CTAP2_OK;
@@ -7,14 +7,18 @@ namespace FIDO2
 {
     namespace Authenticator
     {
-        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::Reset *request, std::unique_ptr<FIDO2::CTAP::Command> &response)
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Request::Reset *request, Arena &arena, FIDO2::CTAP::Command **response)
         {
             Serial.println("## Reset");
 
             Authenticator::reset();
             CredentialsStorage::reset();
 
-            response = std::unique_ptr<FIDO2::CTAP::Response::Reset>(new FIDO2::CTAP::Response::Reset());
+            *response = arena.create<FIDO2::CTAP::Response::Reset>();
+            if (*response == nullptr)
+            {
+                return FIDO2::CTAP::CTAP1_ERR_OTHER;
+            }
 
             // return response;
             return FIDO2::CTAP::CTAP2_OK;
@@ -11,11 +11,14 @@ namespace FIDO2
     {
         namespace BLE
         {
-            CommandBuffer commandBuffer;
+            CommandBufferPool commandBufferPool;
+
+            CommandBuffer responseBuffer;
 
             void CommandBuffer::reset()
             {
                 position = 0;
+                fragments = 0;
             }
 
             uint16_t CommandBuffer::init(const uint8_t *data, const uint16_t length)
@@ -27,12 +30,19 @@ namespace FIDO2
 
                 memcpy(buffer, data, length);
                 position = length;
+                fragments = 1;
 
                 return length;
             }
 
             uint16_t CommandBuffer::append(const uint8_t *data, const uint16_t length)
             {
+                // continuation fragment without the initialization one
+                if (position == 0)
+                {
+                    return 0;
+                }
+
                 if (position + length - 1 > FIDO2_MAX_MSG_SIZE)
                 {
                     return 0;
@@ -40,6 +50,7 @@ namespace FIDO2
 
                 memcpy(buffer + position, data + 1, length - 1);
                 position += length - 1;
+                fragments++;
 
                 return length;
             }
@@ -49,6 +60,16 @@ namespace FIDO2
                 return buffer[0];
             }
 
+            void CommandBuffer::setCmd(uint8_t cmd)
+            {
+                buffer[0] = cmd;
+            }
+
+            CancellationToken &CommandBuffer::getCancellation()
+            {
+                return cancellation;
+            }
+
             uint8_t *CommandBuffer::getBuffer()
             {
                 return buffer;
@@ -69,11 +90,49 @@ namespace FIDO2
                 return buffer[0] != 0 && position == getPayloadLength() + 3;
             }
 
+            uint16_t CommandBuffer::getFragmentCount()
+            {
+                return fragments;
+            }
+
+            /**
+             * Split the frame into fragments of at most maxLength bytes
+             *
+             * @return size of the fragment copied to the output or 0 if the frame has less fragments
+             */
+            uint16_t CommandBuffer::getFragment(const uint16_t index, const uint16_t maxLength, uint8_t *fragment)
+            {
+                if (index == 0)
+                {
+                    const uint16_t size = MIN(maxLength, position);
+                    memcpy(fragment, buffer, size);
+                    return size;
+                }
+
+                // the initialization fragment carries maxLength bytes, continuation ones maxLength - 1
+                const size_t offset = maxLength + (size_t)(index - 1) * (maxLength - 1);
+                if (offset >= position)
+                {
+                    return 0;
+                }
+
+                const uint16_t size = MIN(maxLength - 1, position - offset);
+                fragment[0] = (index - 1) & 0x7f;
+                memcpy(fragment + 1, buffer + offset, size);
+
+                return size + 1;
+            }
+
             uint8_t *CommandBuffer::getPayload()
             {
                 return buffer + 3;
             }
 
+            size_t CommandBuffer::getMaxPayloadLength()
+            {
+                return FIDO2_MAX_MSG_SIZE - 3;
+            }
+
             uint16_t CommandBuffer::getPayloadLength()
             {
                 return be_uint16_t(buffer + 1);
@@ -87,6 +146,56 @@ namespace FIDO2
                 position = length + 3;
             }
 
+            CommandBufferPool::CommandBufferPool()
+            {
+                mux = portMUX_INITIALIZER_UNLOCKED;
+
+                for (size_t i = 0; i < RECEIVE_BUFFER_COUNT; i++)
+                {
+                    used[i] = false;
+                }
+            }
+
+            /**
+             * @return free buffer or nullptr if all the buffers are in use
+             */
+            CommandBuffer *CommandBufferPool::acquire()
+            {
+                CommandBuffer *buffer = nullptr;
+
+                portENTER_CRITICAL(&mux);
+                for (size_t i = 0; i < RECEIVE_BUFFER_COUNT; i++)
+                {
+                    if (!used[i])
+                    {
+                        used[i] = true;
+                        buffer = &buffers[i];
+                        break;
+                    }
+                }
+                portEXIT_CRITICAL(&mux);
+
+                if (buffer != nullptr)
+                {
+                    buffer->reset();
+                }
+
+                return buffer;
+            }
+
+            void CommandBufferPool::release(CommandBuffer *buffer)
+            {
+                portENTER_CRITICAL(&mux);
+                for (size_t i = 0; i < RECEIVE_BUFFER_COUNT; i++)
+                {
+                    if (buffer == &buffers[i])
+                    {
+                        used[i] = false;
+                    }
+                }
+                portEXIT_CRITICAL(&mux);
+            }
+
         } // namespace BLE
     }     // namespace Transport
 } // namespace FIDO2
\ No newline at end of file
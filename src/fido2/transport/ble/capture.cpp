@@ -0,0 +1,282 @@
+#include <Arduino.h>
+
+#include "config.h"
+#include "fido2/transport/ble/capture.h"
+
+#ifdef FIDO2_CAPTURE_ENABLED
+
+#include <esp_timer.h>
+
+#include "ble/device.h"
+#include "util/util.h"
+
+#ifndef FIDO2_CAPTURE_BUFFER_SIZE
+#define FIDO2_CAPTURE_BUFFER_SIZE 8192
+#endif
+
+// the direction is stored in the high bit of the length
+#define LENGTH_MASK 0x7fff
+#define OUTBOUND_FLAG 0x8000
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            /**
+             * Every fragment is stored as a 6 byte header followed by the fragment data.
+             * The oldest records are dropped when the ring is full.
+             */
+            struct __attribute__((packed)) RecordHeader
+            {
+                // lower 32 bits of esp_timer_get_time(), wraps after ~71 minutes
+                uint32_t timestamp;
+                uint16_t length;
+            };
+
+            static uint8_t ring[FIDO2_CAPTURE_BUFFER_SIZE];
+            static size_t head = 0;
+            static size_t tail = 0;
+            static size_t used = 0;
+            static uint16_t records = 0;
+
+            static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+            static void ringWrite(const uint8_t *data, const size_t length)
+            {
+                size_t first = MIN(length, FIDO2_CAPTURE_BUFFER_SIZE - head);
+                memcpy(ring + head, data, first);
+                memcpy(ring, data + first, length - first);
+
+                head = (head + length) % FIDO2_CAPTURE_BUFFER_SIZE;
+                used += length;
+            }
+
+            static void ringRead(const size_t offset, uint8_t *data, const size_t length)
+            {
+                size_t position = offset % FIDO2_CAPTURE_BUFFER_SIZE;
+                size_t first = MIN(length, FIDO2_CAPTURE_BUFFER_SIZE - position);
+                memcpy(data, ring + position, first);
+                memcpy(data + first, ring, length - first);
+            }
+
+            static void ringDropOldest()
+            {
+                RecordHeader header;
+                ringRead(tail, (uint8_t *)&header, sizeof(header));
+
+                const size_t size = sizeof(header) + (header.length & LENGTH_MASK);
+                tail = (tail + size) % FIDO2_CAPTURE_BUFFER_SIZE;
+                used -= size;
+                records--;
+            }
+
+            void captureRecord(const CaptureDirection direction, const uint8_t *data, const size_t length)
+            {
+                const size_t size = sizeof(RecordHeader) + length;
+                if (length > LENGTH_MASK || size > FIDO2_CAPTURE_BUFFER_SIZE)
+                {
+                    return;
+                }
+
+                RecordHeader header = {
+                    .timestamp = (uint32_t)esp_timer_get_time(),
+                    .length = (uint16_t)(length | (direction == CAPTURE_OUTBOUND ? OUTBOUND_FLAG : 0)),
+                };
+
+                portENTER_CRITICAL(&mux);
+                while (FIDO2_CAPTURE_BUFFER_SIZE - used < size)
+                {
+                    ringDropOldest();
+                }
+                ringWrite((uint8_t *)&header, sizeof(header));
+                ringWrite(data, length);
+                records++;
+                portEXIT_CRITICAL(&mux);
+            }
+
+            void captureClear()
+            {
+                portENTER_CRITICAL(&mux);
+                head = tail = used = 0;
+                records = 0;
+                portEXIT_CRITICAL(&mux);
+            }
+
+            /**
+             * Copy the records into a linear buffer, so they can be processed without holding the lock
+             *
+             * @return size of the snapshot in bytes, the caller frees the buffer
+             */
+            static size_t captureSnapshot(uint8_t **snapshot, uint16_t *count)
+            {
+                *snapshot = (uint8_t *)malloc(FIDO2_CAPTURE_BUFFER_SIZE);
+                if (*snapshot == nullptr)
+                {
+                    return 0;
+                }
+
+                portENTER_CRITICAL(&mux);
+                const size_t size = used;
+                ringRead(tail, *snapshot, size);
+                *count = records;
+                portEXIT_CRITICAL(&mux);
+
+                return size;
+            }
+
+            /**
+             * Lines have the format "<direction> <timestamp us> <hex data>", where the direction is
+             * '>' for fragments received from the client and '<' for notifications sent to the client
+             */
+            void captureDump()
+            {
+                uint8_t *snapshot;
+                uint16_t count = 0;
+                const size_t size = captureSnapshot(&snapshot, &count);
+                if (snapshot == nullptr)
+                {
+                    Serial.println("Error: not enough memory for the capture snapshot");
+                    return;
+                }
+
+                Serial.printf("# Capture: %u records, %u bytes\n", count, size);
+
+                size_t offset = 0;
+                while (offset < size)
+                {
+                    RecordHeader header;
+                    memcpy(&header, snapshot + offset, sizeof(header));
+                    offset += sizeof(header);
+
+                    const uint16_t length = header.length & LENGTH_MASK;
+                    Serial.printf("%c %10u ", (header.length & OUTBOUND_FLAG) ? '<' : '>', header.timestamp);
+                    for (uint16_t i = 0; i < length; i++)
+                    {
+                        Serial.printf("%02x", snapshot[offset + i]);
+                    }
+                    Serial.println();
+
+                    offset += length;
+                }
+
+                Serial.println("# Capture end");
+
+                free(snapshot);
+            }
+
+            /**
+             * The capture is cleared before the replay, so it afterwards contains the replayed session
+             * and can be dumped to compare the timing with the original one.
+             * Responses are only delivered when a client is connected, replay without a connection
+             * to measure the processing time alone.
+             */
+            bool captureReplay(ControlPoint *controlPoint)
+            {
+                uint8_t *snapshot;
+                uint16_t count = 0;
+                const size_t size = captureSnapshot(&snapshot, &count);
+                if (snapshot == nullptr)
+                {
+                    return false;
+                }
+
+                captureClear();
+
+                Serial.printf("# Replay: %u records\n", count);
+
+                const int64_t startedAt = esp_timer_get_time();
+
+                uint16_t replayed = 0;
+                uint32_t previous = 0;
+                size_t offset = 0;
+                while (offset < size)
+                {
+                    RecordHeader header;
+                    memcpy(&header, snapshot + offset, sizeof(header));
+                    offset += sizeof(header);
+
+                    const uint16_t length = header.length & LENGTH_MASK;
+                    if ((header.length & OUTBOUND_FLAG) == 0)
+                    {
+                        // keep the spacing of the inbound fragments, the outbound are produced again by the replay
+                        if (replayed > 0 && header.timestamp - previous >= 1000)
+                        {
+                            vTaskDelay(pdMS_TO_TICKS((header.timestamp - previous) / 1000));
+                        }
+                        previous = header.timestamp;
+
+                        controlPoint->ingest(snapshot + offset, length);
+                        replayed++;
+                    }
+
+                    offset += length;
+                }
+
+                Serial.printf("# Replay done: %u fragments in %lu us\n", replayed, (unsigned long)(esp_timer_get_time() - startedAt));
+
+                free(snapshot);
+
+                return true;
+            }
+
+            void captureUpdate()
+            {
+                if (Serial.available() == 0)
+                {
+                    return;
+                }
+
+                switch (Serial.read())
+                {
+                case 'd':
+                    captureDump();
+                    break;
+                case 'c':
+                    captureClear();
+                    Serial.println("# Capture cleared");
+                    break;
+                case 'r':
+                    if (::BLE::server->getConnectedCount() > 0)
+                    {
+                        Serial.println("Error: disconnect the client before the replay");
+                        break;
+                    }
+                    if (!captureReplay(Service::getControlPoint()))
+                    {
+                        Serial.println("Error: not enough memory for the capture snapshot");
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
+
+#else
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            void captureRecord(const CaptureDirection direction, const uint8_t *data, const size_t length) {}
+
+            void captureDump() {}
+
+            void captureClear() {}
+
+            bool captureReplay(ControlPoint *controlPoint) { return false; }
+
+            void captureUpdate() {}
+
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
+
+#endif
\ No newline at end of file
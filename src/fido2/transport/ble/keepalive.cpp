@@ -1,10 +1,9 @@
 #include <Arduino.h>
 
-#include <BLEService.h>
-
+#include "config.h"
 #include "fido2/authenticator/authenticator.h"
-
-#define STACK_SIZE 4096
+#include "fido2/transport/ble/sender.h"
+#include "fido2/transport/ble/service.h"
 
 namespace FIDO2
 {
@@ -12,59 +11,70 @@ namespace FIDO2
     {
         namespace BLE
         {
-            static TaskHandle_t xHandle = NULL;
-            static SemaphoreHandle_t xSemaphore = NULL;
+            static TimerHandle_t xTimer = NULL;
 
-            static void keepaliveTask(void *pvParameters)
+            /**
+             * Executed by the timer service task, must not block
+             */
+            static void keepaliveCallback(TimerHandle_t timer)
             {
-                BLECharacteristic *characteristic = (BLECharacteristic *)pvParameters;
-
-                const TickType_t xDelay = 500 / portTICK_PERIOD_MS;
-
-                while (1)
+                const uint8_t status = FIDO2::Authenticator::getStatus();
+                if (status == FIDO2::Authenticator::STATUS_IDLE)
                 {
-                    vTaskDelay(xDelay);
+                    return;
+                }
 
-                    uint8_t packet[4] = {
-                        0xbe, // CMD_KEEPALIVE,
-                        0x00,
-                        0x01,
-                        FIDO2::Authenticator::getStatus(),
-                    };
+                // skip the keepalive instead of waiting for a response being sent
+                if (!notificationSender.begin(0))
+                {
+                    return;
+                }
 
-                    Serial.println(".");
+                uint8_t packet[4] = {
+                    0x82, // CMD_KEEPALIVE,
+                    0x00,
+                    0x01,
+                    status,
+                };
 
-                    characteristic->setValue(packet, 4);
-                    characteristic->notify();
-                }
+                // a single attempt, the keepalive is dropped when the link is congested or the stack refuses it
+                notificationSender.trySend(packet, sizeof(packet));
+                notificationSender.end();
             }
 
-            bool keepaliveStart(BLECharacteristic *statusCharacteristic)
+            /**
+             * The timer is allocated once and only started and stopped for every request
+             */
+            bool keepaliveInit()
             {
-                if (xHandle != NULL)
+                if (xTimer != NULL)
                 {
-                    // ESP_LOGE(LOG_TAG, "Keepalive task is already running");
                     return false;
                 }
 
-                BaseType_t xReturned = xTaskCreate(keepaliveTask, "BLE::KeepAlive", STACK_SIZE, (void *)statusCharacteristic, 0, &xHandle);
+                xTimer = xTimerCreate("BLE::KeepAlive", pdMS_TO_TICKS(FIDO2_KEEPALIVE_INTERVAL), pdTRUE, NULL, keepaliveCallback);
+
+                return xTimer != NULL;
+            }
 
-                // ESP_LOGD(LOG_TAG, "KeepAlive task create result %d", xReturned);
+            void keepaliveStart()
+            {
+                if (xTimer == NULL)
+                {
+                    return;
+                }
 
-                return ESP_OK;
+                xTimerStart(xTimer, 0);
             }
 
             void keepaliveStop()
             {
-                if (xHandle == NULL)
+                if (xTimer == NULL)
                 {
-                    // ESP_LOGW(LOG_TAG, "No keepalive task");
                     return;
                 }
 
-                vTaskDelete(xHandle);
-
-                xHandle = NULL;
+                xTimerStop(xTimer, 0);
             }
         } // namespace BLE
     }     // namespace Transport
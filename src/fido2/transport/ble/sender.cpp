@@ -0,0 +1,171 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include "fido2/transport/ble/capture.h"
+#include "fido2/transport/ble/sender.h"
+
+#define MAX_RETRIES 3
+#define RETRY_DELAY_MS 10
+#define CONGESTION_TIMEOUT_MS 500
+
+#define EVENT_UNCONGESTED BIT0
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            NotificationSender notificationSender;
+
+            void NotificationSender::init(BLECharacteristic *_characteristic)
+            {
+                characteristic = _characteristic;
+
+                mutex = xSemaphoreCreateMutex();
+
+                events = xEventGroupCreate();
+                xEventGroupSetBits(events, EVENT_UNCONGESTED);
+            }
+
+            /**
+             * Start a new sequence of notifications, the caller owns the characteristic until end() is called
+             */
+            bool NotificationSender::begin(const TickType_t timeout)
+            {
+                if (xSemaphoreTake(mutex, timeout) != pdTRUE)
+                {
+                    return false;
+                }
+
+                memset(&stats, 0, sizeof(stats));
+                startedAt = esp_timer_get_time();
+
+                return true;
+            }
+
+            /**
+             * Notify the client once, the sent notifications are counted
+             */
+            NotificationSender::Result NotificationSender::notify(const uint8_t *data, const size_t length)
+            {
+                // the status is reported synchronously from notify()
+                result = RESULT_PENDING;
+
+                characteristic->setValue((uint8_t *)data, length);
+                characteristic->notify();
+
+                if (result == RESULT_PENDING || result == RESULT_SENT)
+                {
+                    captureRecord(CAPTURE_OUTBOUND, data, length);
+                    stats.fragments++;
+                    stats.bytes += length;
+                    return RESULT_SENT;
+                }
+
+                return result;
+            }
+
+            /**
+             * Send a single notification waiting for the controller buffers to drain if the link is congested.
+             * The congestion state is updated from the BLE stack task, so this must not be called from it.
+             */
+            bool NotificationSender::send(const uint8_t *data, const size_t length)
+            {
+                for (uint8_t attempt = 0; attempt <= MAX_RETRIES; attempt++)
+                {
+                    if (attempt > 0)
+                    {
+                        stats.retries++;
+                        vTaskDelay(pdMS_TO_TICKS(RETRY_DELAY_MS * attempt));
+                    }
+
+                    EventBits_t bits = xEventGroupWaitBits(events, EVENT_UNCONGESTED, pdFALSE, pdTRUE, pdMS_TO_TICKS(CONGESTION_TIMEOUT_MS));
+                    if ((bits & EVENT_UNCONGESTED) == 0)
+                    {
+                        continue;
+                    }
+
+                    switch (notify(data, length))
+                    {
+                    case RESULT_SENT:
+                        return true;
+                    case RESULT_ERROR:
+                        stats.failures++;
+                        return false;
+                    default:
+                        break;
+                    }
+                }
+
+                stats.failures++;
+
+                return false;
+            }
+
+            /**
+             * The notification is dropped when the link is congested or the stack refuses it
+             */
+            bool NotificationSender::trySend(const uint8_t *data, const size_t length)
+            {
+                if (isCongested() || notify(data, length) != RESULT_SENT)
+                {
+                    stats.failures++;
+                    return false;
+                }
+
+                return true;
+            }
+
+            const NotificationSender::Stats &NotificationSender::end()
+            {
+                stats.duration = esp_timer_get_time() - startedAt;
+
+                xSemaphoreGive(mutex);
+
+                return stats;
+            }
+
+            /**
+             * Called from the GATT server event handler
+             */
+            void NotificationSender::setCongested(const bool congested)
+            {
+                if (congested)
+                {
+                    xEventGroupClearBits(events, EVENT_UNCONGESTED);
+                }
+                else
+                {
+                    xEventGroupSetBits(events, EVENT_UNCONGESTED);
+                }
+            }
+
+            bool NotificationSender::isCongested()
+            {
+                return (xEventGroupGetBits(events) & EVENT_UNCONGESTED) == 0;
+            }
+
+            void NotificationSender::setNotifyStatus(const BLECharacteristicCallbacks::Status status)
+            {
+                switch (status)
+                {
+                case BLECharacteristicCallbacks::Status::SUCCESS_NOTIFY:
+                    result = RESULT_SENT;
+                    break;
+                case BLECharacteristicCallbacks::Status::ERROR_GATT:
+                    result = RESULT_TRANSIENT_ERROR;
+                    break;
+                case BLECharacteristicCallbacks::Status::ERROR_NO_CLIENT:
+                case BLECharacteristicCallbacks::Status::ERROR_NOTIFY_DISABLED:
+                    result = RESULT_ERROR;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
\ No newline at end of file
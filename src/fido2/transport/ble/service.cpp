@@ -1,18 +1,23 @@
-#include <memory>
-
 #include <Arduino.h>
 
 #include <BLE2902.h>
 #include <BLEService.h>
 
+#include "ble/connection.h"
 #include "ble/device.h"
 #include "config.h"
 #include "fido2/authenticator/authenticator.h"
 #include "fido2/ctap/ctap.h"
 #include "fido2/transport/ble/buffer.h"
+#include "fido2/transport/ble/capture.h"
+#include "fido2/transport/ble/sender.h"
 #include "fido2/transport/ble/service.h"
+#include "util/arena.h"
 #include "util/util.h"
 
+// size of the arena holding the request and response objects of one transaction, which take less than 512 bytes
+#define TRANSACTION_ARENA_SIZE 1024
+
 namespace FIDO2
 {
     namespace Transport
@@ -20,9 +25,25 @@ namespace FIDO2
         namespace BLE
         {
             BLEService *Service::fido2Service = nullptr;
+            ControlPoint *Service::controlPoint = nullptr;
 
             BLECharacteristic *statusCharacteristic = nullptr;
 
+            static void gattsEventHandler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param)
+            {
+                switch (event)
+                {
+                case ESP_GATTS_CONGEST_EVT:
+                    notificationSender.setCongested(param->congest.congested);
+                    break;
+                case ESP_GATTS_DISCONNECT_EVT:
+                    notificationSender.setCongested(false);
+                    break;
+                default:
+                    break;
+                }
+            }
+
             BLEUUID Service::UUID()
             {
                 return BLEUUID((uint16_t)0xFFFD);
@@ -33,14 +54,31 @@ namespace FIDO2
                 fido2Service = ::BLE::server->createService(Service::UUID());
 
                 // FIDO Control Point
+                controlPoint = new ControlPoint();
                 fido2Service
                     ->createCharacteristic(ControlPoint::UUID(), BLECharacteristic::PROPERTY_WRITE)
-                    ->setCallbacks(new ControlPoint());
+                    ->setCallbacks(controlPoint);
+
+                // CTAP requests are processed outside of the BLE stack callbacks
+                if (!workerStart(controlPoint))
+                {
+                    Serial.println("Error: could not start FIDO2 worker");
+                }
 
                 // FIDO Status
                 statusCharacteristic = fido2Service
                                            ->createCharacteristic(Status::UUID(), BLECharacteristic::PROPERTY_NOTIFY);
                 statusCharacteristic->addDescriptor(new BLE2902());
+                statusCharacteristic->setCallbacks(new Status());
+
+                // notifications are paced according to the congestion state of the link
+                notificationSender.init(statusCharacteristic);
+                BLEDevice::setCustomGattsHandler(gattsEventHandler);
+
+                if (!keepaliveInit())
+                {
+                    Serial.println("Error: could not create FIDO2 keepalive timer");
+                }
 
                 // FIDO Control Point Length
                 fido2Service
@@ -55,171 +93,276 @@ namespace FIDO2
                 fido2Service->start();
             }
 
+            ControlPoint *Service::getControlPoint()
+            {
+                return controlPoint;
+            }
+
             BLEUUID ControlPoint::UUID()
             {
                 return BLEUUID("F1D0FFF1-DEAA-ECEE-B42F-C9BA7ED623BB");
             }
 
+            /**
+             * Control point length for the current connection derived from the negotiated ATT MTU.
+             * A write request or a notification carries at most MTU - 3 bytes of the attribute value, this
+             * applies to the default MTU of 23 as well, before the MTU exchange or when it never happens.
+             */
+            uint16_t ControlPoint::getLength()
+            {
+                const uint16_t mtu = ::BLE::server->getPeerMTU(::BLE::server->getConnId());
+
+                return MAX(20, MIN(mtu - 3, FIDO2_CONTROL_POINT_MAX_LENGTH));
+            }
+
             /**
              * fidoControlPoint is a write-only command buffer.
+             *
+             * Fragments are read directly from the characteristic storage and copied once into their final
+             * position in the reassembly buffer, the CTAP parser then reads the payload in place.
              */
             void ControlPoint::onWrite(BLECharacteristic *pCharacteristic)
             {
-                std::string value = pCharacteristic->getValue();
-                if (value.length() == 0)
+                ingest(pCharacteristic->getData(), pCharacteristic->getLength());
+            }
+
+            /**
+             * Process a single fragment written by the client or replayed from a capture
+             */
+            void ControlPoint::ingest(const uint8_t *data, const size_t length)
+            {
+                if (data == nullptr || length == 0)
                 {
                     return;
                 }
 
+                captureRecord(CAPTURE_INBOUND, data, length);
+
                 // A frame is divided into an initialization fragment and zero or more continuation fragments.
-                uint8_t cmd = value[0];
+                uint8_t cmd = data[0];
                 if (cmd >= 0x80)
                 {
                     // Serial.println("Initialization Fragment");
+                    // abort the request the worker is processing, it responds with CTAP2_ERR_KEEPALIVE_CANCEL,
+                    // the queued requests are processed afterwards
+                    if (cmd == CMD_CANCEL)
+                    {
+                        Serial.println("CANCEL");
+                        workerCancel();
+                        return;
+                    }
+
+                    // reassemble into a free buffer while the previous requests are processed
+                    if (receiving == nullptr)
+                    {
+                        receiving = commandBufferPool.acquire();
+                        if (receiving == nullptr)
+                        {
+                            sendError(ERR_BUSY);
+                            return;
+                        }
+                    }
+
                     // The start of an initialization fragment is indicated by setting the high bit in the first byte.
                     // The subsequent two bytes indicate the total length of the frame, in big-endian order.
                     // The first maxLen - 3 bytes of data follow.
-                    if (commandBuffer.init((const uint8_t *)value.c_str(), value.length()) == 0)
+                    if (receiving->init(data, length) == 0)
                     {
                         // error
                     }
+                    else
+                    {
+                        // switch to the short connection interval for the rest of the transaction, frames
+                        // rejected as busy or too long leave the connection parameters alone
+                        ::BLE::Connection::beginTransaction();
+                    }
                 }
                 else
                 {
+                    // continuation of the frame rejected as busy
+                    if (receiving == nullptr)
+                    {
+                        return;
+                    }
+
                     // Serial.println("Continuation Fragment");
                     // Continuation fragments begin with a sequence number, beginning at 0, implicitly with the high bit cleared.
                     // The sequence number must wraparound to 0 after reaching the maximum sequence number of 0x7f.
-                    if (commandBuffer.append((const uint8_t *)value.c_str(), value.length()) == 0)
+                    if (receiving->append(data, length) == 0)
                     {
                         // error
                     }
                 }
 
                 //
-                if (commandBuffer.isComplete())
+                if (receiving->isComplete())
                 {
-                    // Serial.printf("\n# Received command 0x%02x with payload\n", commandBuffer.getCmd());
-                    // serialDumpBuffer(commandBuffer.getPayload(), commandBuffer.getPayloadLength());
-                    processRequest();
+                    // Serial.printf("\n# Received command 0x%02x with payload\n", receiving->getCmd());
+                    // serialDumpBuffer(receiving->getPayload(), receiving->getPayloadLength());
+
+                    // a CANCEL received before this request applies to the previous one
+                    receiving->getCancellation().reset();
+
+                    // the buffer is owned by the worker until the response is sent
+                    if (!workerSubmit(receiving))
+                    {
+                        commandBufferPool.release(receiving);
+                        sendError(ERR_BUSY);
+                    }
+
+                    receiving = nullptr;
                 }
             }
 
-            void ControlPoint::processRequest()
+            /**
+             * Executed by the worker task
+             */
+            void ControlPoint::processRequest(CommandBuffer &request)
             {
-                switch (commandBuffer.getCmd())
+                const uint16_t received = request.getFragmentCount();
+
+                uint16_t sent = 0;
+                switch (request.getCmd())
                 {
                 case CMD_PING:
+                    // the response echoes the request
                     Serial.println("PING");
-                    statusCharacteristic->setValue(commandBuffer.getBuffer(), commandBuffer.getBufferLength());
-                    statusCharacteristic->notify();
+                    sent = sendResponse(request);
                     break;
                 case CMD_MSG:
-                    processMessage();
+                    processMessage(request, responseBuffer);
+                    sent = sendResponse(responseBuffer);
                     break;
-                case CMD_CANCEL:
-                    Serial.println("CANCEL");
+                default:
                     break;
                 }
+
+                Serial.printf("# Fragments received: %u, sent: %u, control point length: %u\n", received, sent, getLength());
+
+                // relax the connection parameters unless the next request follows shortly
+                ::BLE::Connection::endTransaction();
             }
 
-            void ControlPoint::processMessage()
+            // request and response objects of the transaction being processed
+            alignas(8) static uint8_t transactionBuffer[TRANSACTION_ARENA_SIZE];
+            static Arena transactionArena(transactionBuffer, sizeof(transactionBuffer));
+
+            /**
+             * Parse, execute and encode a CTAP command, the first error status is returned to the client.
+             * The response parameters are encoded directly into the transmit buffer.
+             */
+            static FIDO2::CTAP::Status processCommand(const uint8_t *data, const size_t length, Arena &arena, FIDO2::CTAP::Encoder &encoder, const CancellationToken &cancellation)
+            {
+                // parse the request
+                FIDO2::CTAP::Command *ctapRequest = nullptr;
+                RETURN_IF_ERROR(FIDO2::CTAP::Request::parse(data, length, arena, &ctapRequest));
+
+                // execute
+                FIDO2::CTAP::Command *ctapResponse = nullptr;
+                RETURN_IF_ERROR(FIDO2::Authenticator::processRequest(ctapRequest, arena, &ctapResponse, cancellation));
+
+                // encode the response
+                if (ctapResponse != nullptr)
+                {
+                    RETURN_IF_ERROR(FIDO2::CTAP::Response::encode(ctapResponse, encoder));
+                }
+
+                return FIDO2::CTAP::CTAP2_OK;
+            }
+
+            /**
+             * The response is written to a separate buffer, so the request stays intact while it is processed
+             */
+            void ControlPoint::processMessage(CommandBuffer &request, CommandBuffer &response)
             {
                 Serial.printf("\n# Received Command\n");
-                serialDumpBuffer(commandBuffer.getPayload(), commandBuffer.getPayloadLength());
+                serialDumpBuffer(request.getPayload(), request.getPayloadLength());
+
+                response.setCmd(CMD_MSG);
 
                 // start keepalive
-                // keepaliveStart(statusCharacteristic);
+                keepaliveStart();
 
-                try
-                {
-                    // parse the request
-                    std::unique_ptr<FIDO2::CTAP::Command> request;
-                    FIDO2::CTAP::Status statusParse = FIDO2::CTAP::Request::parse(commandBuffer.getPayload(), commandBuffer.getPayloadLength(), request);
-                    assert(request != nullptr);
-
-                    // execute
-                    std::unique_ptr<FIDO2::CTAP::Command> response;
-                    FIDO2::CTAP::Status statusProcess = FIDO2::Authenticator::processRequest(request.get(), response);
-                    if (statusProcess != FIDO2::CTAP::CTAP2_OK)
-                    {
-                        throw FIDO2::CTAP::Exception(statusProcess);
-                    }
+                // the status byte is followed by the parameters
+                uint8_t *payload = response.getPayload();
+                FIDO2::CTAP::Encoder encoder(payload + 1, response.getMaxPayloadLength() - 1);
 
-                    std::unique_ptr<CBOR> cborResponse;
-                    if (response != nullptr)
-                    {
-                        // encode the response
-                        FIDO2::CTAP::Status statusEncode = FIDO2::CTAP::Response::encode(response.get(), cborResponse);
-                        if (statusEncode != FIDO2::CTAP::CTAP2_OK)
-                        {
-                            throw FIDO2::CTAP::Exception(statusEncode);
-                        }
-                    }
+                FIDO2::CTAP::Status status = processCommand(request.getPayload(), request.getPayloadLength(), transactionArena, encoder, request.getCancellation());
 
-                    // send successful result
-                    uint8_t *payload = commandBuffer.getPayload();
-                    payload[0] = FIDO2::CTAP::CTAP2_OK;
-                    if (cborResponse != nullptr && cborResponse->length() > 0)
-                    {
-                        memcpy(payload + 1, cborResponse->to_CBOR(), cborResponse->length());
-                        commandBuffer.setPayloadLength(cborResponse->length() + 1);
-                    }
-                    else
-                    {
-                        commandBuffer.setPayloadLength(1);
-                    }
-                }
-                catch (FIDO2::CTAP::Exception &e)
-                {
-                    uint8_t *payload = commandBuffer.getPayload();
-                    payload[0] = e.getStatus();
-                    commandBuffer.setPayloadLength(1);
-                }
+                payload[0] = status;
+                response.setPayloadLength(status == FIDO2::CTAP::CTAP2_OK ? encoder.getLength() + 1 : 1);
+
+                // the request and the response objects are released at once
+                transactionArena.reset();
 
                 // stop keepalive
-                // keepaliveStop();
+                keepaliveStop();
+            }
+
+            /**
+             * Notify the client about a transport level error
+             */
+            void ControlPoint::sendError(const uint8_t error)
+            {
+                uint8_t packet[4] = {
+                    CMD_ERROR,
+                    0x00,
+                    0x01,
+                    error,
+                };
 
-                sendResponse();
+                // called from the BLE stack callbacks, which deliver the congestion events as well, so the error
+                // is dropped instead of waiting for the link or for a response being transmitted
+                if (!notificationSender.begin(0))
+                {
+                    Serial.printf("! Could not send error 0x%02x\n", error);
+                    return;
+                }
+
+                if (!notificationSender.trySend(packet, sizeof(packet)))
+                {
+                    Serial.printf("! Dropped error 0x%02x\n", error);
+                }
+                notificationSender.end();
             }
 
             /**
-             * Send the response with splitting in frames of FIDO2_CONTROL_POINT_LENGTH size
+             * Send the response with splitting in frames of the control point length
+             *
+             * @return number of sent fragments
              */
-            void ControlPoint::sendResponse()
+            uint16_t ControlPoint::sendResponse(CommandBuffer &buffer)
             {
                 Serial.println("Responding with payload");
-                serialDumpBuffer(commandBuffer.getPayload(), commandBuffer.getPayloadLength());
+                serialDumpBuffer(buffer.getPayload(), buffer.getPayloadLength());
+
+                // the same fragment size is used for the whole response
+                const uint16_t length = getLength();
+
+                notificationSender.begin();
 
                 // send the response back
-                uint8_t sendBuffer[FIDO2_CONTROL_POINT_LENGTH];
-                size_t sent = 0;
-                size_t copySize, sendSize;
-                for (uint8_t seq = 0; sent < commandBuffer.getBufferLength(); seq++)
+                uint8_t fragment[FIDO2_CONTROL_POINT_MAX_LENGTH];
+                uint16_t fragmentSize;
+                for (uint16_t index = 0; (fragmentSize = buffer.getFragment(index, length, fragment)) > 0; index++)
                 {
-                    if (seq == 0)
+                    // Serial.printf("index: %d\n", index);
+                    // serialDumpBuffer(fragment, fragmentSize);
+
+                    if (!notificationSender.send(fragment, fragmentSize))
                     {
-                        sendSize = MIN(FIDO2_CONTROL_POINT_LENGTH, commandBuffer.getBufferLength());
-                        memcpy(sendBuffer, commandBuffer.getBuffer(), sendSize);
-                        sent += sendSize;
+                        Serial.println("! Could not send the response");
+                        break;
                     }
-                    else
-                    {
-                        sendBuffer[0] = seq - 1;
-
-                        copySize = MIN(FIDO2_CONTROL_POINT_LENGTH - 1, commandBuffer.getBufferLength() - sent);
-                        memcpy(sendBuffer + 1, commandBuffer.getBuffer() + sent, copySize);
+                }
 
-                        sent += copySize;
-                        sendSize = copySize + 1;
-                    }
+                const NotificationSender::Stats stats = notificationSender.end();
 
-                    // Serial.printf("seq: %d\n", seq);
-                    // Serial.printf("size: %d\n", sendSize);
-                    // serialDumpBuffer(sendBuffer, sendSize);
+                const unsigned long throughput = stats.duration > 0 ? (unsigned long)(stats.bytes * 1000000LL / stats.duration) : 0;
+                Serial.printf("# Sent %u bytes in %u fragments within %lu us (%lu B/s), %u retries, %u failures\n",
+                              (unsigned)stats.bytes, stats.fragments, (unsigned long)stats.duration, throughput, stats.retries, stats.failures);
 
-                    statusCharacteristic->setValue(sendBuffer, sendSize);
-                    statusCharacteristic->notify();
-                }
+                return stats.fragments;
             }
 
             BLEUUID Status::UUID()
@@ -227,6 +370,14 @@ namespace FIDO2
                 return BLEUUID("F1D0FFF2-DEAA-ECEE-B42F-C9BA7ED623BB");
             }
 
+            /**
+             * Reports the result of each notification to the sender
+             */
+            void Status::onStatus(BLECharacteristic *pCharacteristic, BLECharacteristicCallbacks::Status s, uint32_t code)
+            {
+                notificationSender.setNotifyStatus(s);
+            }
+
             BLEUUID ControlPointLength::UUID()
             {
                 return BLEUUID("F1D0FFF3-DEAA-ECEE-B42F-C9BA7ED623BB");
@@ -238,9 +389,11 @@ namespace FIDO2
              */
             void ControlPointLength::onRead(BLECharacteristic *pCharacteristic)
             {
+                const uint16_t length = ControlPoint::getLength();
+
                 uint8_t value[] = {
-                    (FIDO2_CONTROL_POINT_LENGTH >> 8) & 0xFF,
-                    FIDO2_CONTROL_POINT_LENGTH & 0xFF,
+                    (uint8_t)((length >> 8) & 0xFF),
+                    (uint8_t)(length & 0xFF),
                 };
                 pCharacteristic->setValue(value, sizeof(value));
             }
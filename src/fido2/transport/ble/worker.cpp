@@ -0,0 +1,132 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include "fido2/transport/ble/buffer.h"
+#include "fido2/transport/ble/service.h"
+
+#define STACK_SIZE 8192
+#define QUEUE_LENGTH RECEIVE_BUFFER_COUNT
+
+namespace FIDO2
+{
+    namespace Transport
+    {
+        namespace BLE
+        {
+            struct WorkItem
+            {
+                CommandBuffer *buffer;
+                int64_t receivedAt;
+            };
+
+            static TaskHandle_t xHandle = NULL;
+            static QueueHandle_t xQueue = NULL;
+
+            // number of requests submitted and not yet responded
+            static volatile uint8_t pending = 0;
+            static portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
+
+            // request taken off the queue and being processed, the target of CANCEL
+            static CommandBuffer *processing = nullptr;
+
+            static void workerTask(void *pvParameters)
+            {
+                ControlPoint *controlPoint = (ControlPoint *)pvParameters;
+
+                WorkItem item;
+
+                while (1)
+                {
+                    if (xQueueReceive(xQueue, &item, portMAX_DELAY) != pdTRUE)
+                    {
+                        continue;
+                    }
+
+                    portENTER_CRITICAL(&pendingMux);
+                    processing = item.buffer;
+                    portEXIT_CRITICAL(&pendingMux);
+
+                    const int64_t startedAt = esp_timer_get_time();
+
+                    controlPoint->processRequest(*item.buffer);
+
+                    const int64_t finishedAt = esp_timer_get_time();
+
+                    portENTER_CRITICAL(&pendingMux);
+                    processing = nullptr;
+                    portEXIT_CRITICAL(&pendingMux);
+
+                    commandBufferPool.release(item.buffer);
+
+                    Serial.printf("# Request queued for %lu us, processed in %lu us\n",
+                                  (unsigned long)(startedAt - item.receivedAt),
+                                  (unsigned long)(finishedAt - startedAt));
+
+                    portENTER_CRITICAL(&pendingMux);
+                    pending--;
+                    portEXIT_CRITICAL(&pendingMux);
+                }
+            }
+
+            bool workerStart(ControlPoint *controlPoint)
+            {
+                if (xHandle != NULL)
+                {
+                    return false;
+                }
+
+                xQueue = xQueueCreate(QUEUE_LENGTH, sizeof(WorkItem));
+                if (xQueue == NULL)
+                {
+                    return false;
+                }
+
+                return xTaskCreate(workerTask, "FIDO2::Worker", STACK_SIZE, (void *)controlPoint, 1, &xHandle) == pdPASS;
+            }
+
+            /**
+             * Queue the complete request for processing, never blocks the caller
+             */
+            bool workerSubmit(CommandBuffer *buffer)
+            {
+                WorkItem item = {
+                    .buffer = buffer,
+                    .receivedAt = esp_timer_get_time(),
+                };
+
+                portENTER_CRITICAL(&pendingMux);
+                pending++;
+                portEXIT_CRITICAL(&pendingMux);
+
+                if (xQueueSend(xQueue, &item, 0) != pdTRUE)
+                {
+                    portENTER_CRITICAL(&pendingMux);
+                    pending--;
+                    portEXIT_CRITICAL(&pendingMux);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool workerIsBusy()
+            {
+                return pending > 0;
+            }
+
+            /**
+             * Cancel the request being processed, queued requests are not affected
+             */
+            void workerCancel()
+            {
+                portENTER_CRITICAL(&pendingMux);
+                if (processing != nullptr)
+                {
+                    processing->getCancellation().cancel();
+                }
+                portEXIT_CRITICAL(&pendingMux);
+            }
+        } // namespace BLE
+    }     // namespace Transport
+} // namespace FIDO2
\ No newline at end of file
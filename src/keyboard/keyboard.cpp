@@ -2,6 +2,7 @@
 
 #include <Adafruit_MPR121.h>
 
+#include "config.h"
 #include "keyboard/keyboard.h"
 
 namespace Keyboard
@@ -44,23 +45,34 @@ namespace Keyboard
     {
     }
 
-    bool waitForTouch(const char key, const unsigned long timeout)
+    /**
+     * @brief Wait for the key to be touched, gives up when the timeout expires or the token is cancelled
+     */
+    bool waitForTouch(const char key, const unsigned long timeout, const CancellationToken *token)
     {
-        unsigned long start = millis();
-
-        // do
-        // {
-        //     // char touched = getTouched();
-        //     // if (touched == key)
-        //     // {
-        //     //     return true;
-        //     // }
-        //     yield();
-        //     delay(100);
-        // } while (millis() < start + timeout);
-
-        // return false;
-        return true;
+        const unsigned long start = millis();
+
+        do
+        {
+            if (token != nullptr && token->isCancelled())
+            {
+                return false;
+            }
+
+#ifdef KEYBOARD_ENABLED
+            if (getTouched() == key)
+            {
+                return true;
+            }
+#else
+            // without a keyboard the user is assumed to be present
+            return true;
+#endif
+
+            delay(100);
+        } while (millis() - start < timeout);
+
+        return false;
     }
 
 } // namespace Keyboard
\ No newline at end of file
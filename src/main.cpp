@@ -5,10 +5,13 @@
 
 #include "config.h"
 
+#include "benchmark/benchmark.h"
+
 #include "fido2/authenticator/authenticator.h"
 
 #include "ble/device.h"
 #include "fido2/transport/ble/service.h"
+#include "fido2/transport/ble/capture.h"
 
 #include "display/display.h"
 #include "keyboard/keyboard.h"
@@ -41,6 +44,8 @@ void setup()
 
     FIDO2::Authenticator::powerUp();
 
+    Benchmark::run();
+
     FIDO2::Transport::BLE::Service::init();
 
     BLE::start();
@@ -54,5 +59,7 @@ void loop()
 
     Keyboard::update();
 
+    FIDO2::Transport::BLE::captureUpdate();
+
     delay(50);
 }
\ No newline at end of file
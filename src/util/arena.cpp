@@ -0,0 +1,39 @@
+#include <Arduino.h>
+
+#include "util/arena.h"
+
+Arena::Arena(uint8_t *buffer, const size_t size) : buffer(buffer), size(size), used(0), peak(0)
+{
+}
+
+void *Arena::allocate(const size_t size, const size_t alignment)
+{
+    const size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start > this->size || size > this->size - start)
+    {
+        return nullptr;
+    }
+
+    used = start + size;
+    if (used > peak)
+    {
+        peak = used;
+    }
+
+    return buffer + start;
+}
+
+void Arena::reset()
+{
+    used = 0;
+}
+
+size_t Arena::getUsed() const
+{
+    return used;
+}
+
+size_t Arena::getPeak() const
+{
+    return peak;
+}
\ No newline at end of file
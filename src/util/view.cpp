@@ -0,0 +1,38 @@
+#include <Arduino.h>
+
+#include "util/util.h"
+#include "util/view.h"
+
+bool StringView::equals(const char *str) const
+{
+    return strlen(str) == length && memcmp(data, str, length) == 0;
+}
+
+bool StringView::equals(const String &str) const
+{
+    return str.length() == length && memcmp(data, str.c_str(), length) == 0;
+}
+
+size_t StringView::copyTo(char *buffer, const size_t size) const
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    const size_t copied = MIN(length, size - 1);
+    memcpy(buffer, data, copied);
+    buffer[copied] = '\0';
+
+    return copied;
+}
+
+void StringView::toString(String &str) const
+{
+    str = "";
+    str.reserve(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        str += data[i];
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <thread>
+
+#include "crypto/crypto.h"
+
+#include "atecc.h"
+
+namespace Crypto
+{
+    namespace SHA256
+    {
+        /**
+         * Emulated secure element, the digest is computed in software and returned once the modelled
+         * I2C transfers and SHA commands would have completed
+         */
+        bool hashSecureElement(const uint8_t *data, const size_t length, uint8_t *sha)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            const bool success = hashSoftware(data, length, sha);
+
+            std::this_thread::sleep_until(start + std::chrono::microseconds(modelSecureElement(length)));
+
+            return success;
+        }
+    } // namespace SHA256
+} // namespace Crypto
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// latency model of the secure element: I2C at 100 kHz takes 9 bit times per byte, the execution time is the
+// maximum of the SHA command in the ATECC508A datasheet
+#define MODEL_BYTE_TIME 90
+#define MODEL_SHA_EXECUTION 9000
+
+/**
+ * SHA start, one update per full block and end with the rest of the data, every command packet has 7 bytes
+ * around the data and returns a status, the last one returns the digest
+ *
+ * @return modelled time of a hash in microseconds
+ */
+inline uint32_t modelSecureElement(const size_t length)
+{
+    const uint32_t commands = 2 + length / 64;
+    const uint32_t sent = commands * 7 + length;
+    const uint32_t received = (commands - 1) * 4 + 35;
+
+    return commands * MODEL_SHA_EXECUTION + (sent + received) * MODEL_BYTE_TIME;
+}
\ No newline at end of file
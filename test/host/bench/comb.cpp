@@ -0,0 +1,303 @@
+#include <Arduino.h>
+
+#include <uECC.h>
+
+#include <chrono>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+#include "stats.h"
+
+/**
+ * Public keys and signatures of the P-256 comb against micro-ecc, the reference for the field and point
+ * arithmetic. Every public key has to match uECC_compute_public_key, for random scalars and for the edges of
+ * the comb, and every signature has to pass uECC_verify. The run fails on any mismatch.
+ */
+
+#define ITERATIONS 100
+
+#define COMB_TEETH 6
+#define COMB_SPACING 43
+
+// order of the P-256 group, big-endian
+static const uint8_t order[32] = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84, 0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51};
+
+struct Scalar
+{
+    const char *name;
+    Crypto::ECDSA::PrivateKey key;
+};
+
+static int randomBytes(uint8_t *dest, unsigned size)
+{
+    esp_fill_random(dest, size);
+    return 1;
+}
+
+static void setBit(Crypto::ECDSA::PrivateKey &key, const unsigned bit)
+{
+    key.key[31 - bit / 8] |= 1 << (bit % 8);
+}
+
+/**
+ * order - value for a small value, without borrows past the lowest byte
+ */
+static Crypto::ECDSA::PrivateKey belowOrder(const uint8_t value)
+{
+    Crypto::ECDSA::PrivateKey key;
+    memcpy(key.key, order, sizeof(key.key));
+    key.key[31] -= value;
+
+    return key;
+}
+
+/**
+ * Scalars at the edges of the range and of the comb: the smallest and the largest ones, a single tooth, all the
+ * teeth of a column set so the last entry of the table is selected, and the high teeth taken from n - 1
+ */
+static void buildEdges(std::vector<Scalar> &valid, std::vector<Scalar> &invalid)
+{
+    Scalar scalar;
+
+    scalar = {"1", {}};
+    setBit(scalar.key, 0);
+    valid.push_back(scalar);
+
+    scalar = {"2", {}};
+    setBit(scalar.key, 1);
+    valid.push_back(scalar);
+
+    scalar = {"n - 1", belowOrder(1)};
+    valid.push_back(scalar);
+
+    scalar = {"n - 2", belowOrder(2)};
+    valid.push_back(scalar);
+
+    scalar = {"2^255", {}};
+    setBit(scalar.key, 255);
+    valid.push_back(scalar);
+
+    scalar = {"all teeth of column 0", {}};
+    for (unsigned tooth = 0; tooth < COMB_TEETH; tooth++)
+    {
+        setBit(scalar.key, tooth * COMB_SPACING);
+    }
+    valid.push_back(scalar);
+
+    // the highest column where the last tooth is within 256 bits
+    scalar = {"all teeth of column 40", {}};
+    for (unsigned tooth = 0; tooth < COMB_TEETH; tooth++)
+    {
+        setBit(scalar.key, tooth * COMB_SPACING + 40);
+    }
+    valid.push_back(scalar);
+
+    // the lower teeth are missing from the last column
+    scalar = {"teeth 0-4 of column 42", {}};
+    for (unsigned tooth = 0; tooth < COMB_TEETH - 1; tooth++)
+    {
+        setBit(scalar.key, tooth * COMB_SPACING + 42);
+    }
+    valid.push_back(scalar);
+
+    // bits 168 to 255, the teeth 4 and 5 and the top of tooth 3
+    scalar = {"n - 1 above bit 168", belowOrder(1)};
+    memset(scalar.key.key + 32 - 4 * COMB_SPACING / 8, 0, 4 * COMB_SPACING / 8);
+    valid.push_back(scalar);
+
+    scalar = {"0", {}};
+    invalid.push_back(scalar);
+
+    scalar = {"n", belowOrder(0)};
+    invalid.push_back(scalar);
+
+    scalar = {"every bit of tooth 5", {}};
+    for (unsigned bit = 5 * COMB_SPACING; bit < 256; bit++)
+    {
+        setBit(scalar.key, bit);
+    }
+    invalid.push_back(scalar);
+}
+
+static uint32_t elapsedSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printLatency(const char *name, std::vector<uint32_t> &samples)
+{
+    printf(" * %s: p50 %u us, p90 %u us, p99 %u us\n", name, percentile(samples, 50), percentile(samples, 90), percentile(samples, 99));
+}
+
+static void printSpeedup(std::vector<uint32_t> &baseline, std::vector<uint32_t> &samples)
+{
+    // median against median, in hundredths
+    const uint32_t speedup = percentile(baseline, 50) * 100 / std::max<uint32_t>(percentile(samples, 50), 1);
+    printf(" * speedup: %u.%02ux\n", speedup / 100, speedup % 100);
+}
+
+/**
+ * @return number of public keys differing from micro-ecc
+ */
+static uint32_t runPublicKeys()
+{
+    std::vector<Scalar> valid;
+    std::vector<Scalar> invalid;
+    buildEdges(valid, invalid);
+
+    uint32_t mismatches = 0;
+
+    printf("# public key derivation, edges\n");
+
+    for (const Scalar &scalar : valid)
+    {
+        Crypto::ECDSA::PublicKey expected;
+        Crypto::ECDSA::PublicKey publicKey;
+        const bool computed = uECC_compute_public_key(scalar.key.key, (uint8_t *)&expected, Crypto::ECDSA::_es256_curve);
+        Crypto::ECDSA::derivePublicKey(&scalar.key, &publicKey);
+
+        if (!computed || memcmp(&expected, &publicKey, sizeof(publicKey)) != 0)
+        {
+            printf(" ! %s\n", scalar.name);
+            mismatches++;
+        }
+    }
+
+    // rejected by both, the comb returns the point at infinity as zeros
+    const Crypto::ECDSA::PublicKey zero = {};
+    for (const Scalar &scalar : invalid)
+    {
+        Crypto::ECDSA::PublicKey expected;
+        Crypto::ECDSA::PublicKey publicKey;
+        const bool computed = uECC_compute_public_key(scalar.key.key, (uint8_t *)&expected, Crypto::ECDSA::_es256_curve);
+        Crypto::ECDSA::derivePublicKey(&scalar.key, &publicKey);
+
+        uint8_t signature[64];
+        const uint8_t hash[32] = {};
+        if (computed || memcmp(&zero, &publicKey, sizeof(publicKey)) != 0 || Crypto::ECDSA::sign(&scalar.key, hash, signature))
+        {
+            printf(" ! %s is accepted\n", scalar.name);
+            mismatches++;
+        }
+    }
+
+    printf(" * scalars: %zu valid, %zu invalid\n", valid.size(), invalid.size());
+
+    std::vector<uint32_t> baseline;
+    std::vector<uint32_t> samples;
+    baseline.reserve(ITERATIONS);
+    samples.reserve(ITERATIONS);
+
+    for (auto i = 0; i < ITERATIONS; i++)
+    {
+        Crypto::ECDSA::PrivateKey privateKey;
+        Crypto::ECDSA::generatePrivateKey(&privateKey);
+
+        Crypto::ECDSA::PublicKey expected;
+        auto start = std::chrono::steady_clock::now();
+        uECC_compute_public_key(privateKey.key, (uint8_t *)&expected, Crypto::ECDSA::_es256_curve);
+        baseline.push_back(elapsedSince(start));
+
+        Crypto::ECDSA::PublicKey publicKey;
+        start = std::chrono::steady_clock::now();
+        Crypto::ECDSA::derivePublicKey(&privateKey, &publicKey);
+        samples.push_back(elapsedSince(start));
+
+        if (memcmp(&expected, &publicKey, sizeof(publicKey)) != 0)
+        {
+            mismatches++;
+        }
+    }
+
+    printf("# public key derivation, %u random scalars\n", ITERATIONS);
+    printLatency("micro-ecc", baseline);
+    printLatency("comb", samples);
+    printSpeedup(baseline, samples);
+    printf(" * mismatches: %u\n", mismatches);
+
+    return mismatches;
+}
+
+/**
+ * @return number of signatures rejected by micro-ecc
+ */
+static uint32_t runSignatures()
+{
+    std::vector<Scalar> valid;
+    std::vector<Scalar> invalid;
+    buildEdges(valid, invalid);
+
+    std::vector<uint32_t> baseline;
+    std::vector<uint32_t> samples;
+    baseline.reserve(ITERATIONS);
+    samples.reserve(ITERATIONS);
+
+    uint32_t failures = 0;
+
+    for (auto i = 0; i < ITERATIONS; i++)
+    {
+        // the edge scalars first, then random keys
+        Crypto::ECDSA::PrivateKey privateKey;
+        if (i < valid.size())
+        {
+            privateKey = valid[i].key;
+        }
+        else
+        {
+            Crypto::ECDSA::generatePrivateKey(&privateKey);
+        }
+
+        Crypto::ECDSA::PublicKey publicKey;
+        Crypto::ECDSA::derivePublicKey(&privateKey, &publicKey);
+
+        // a hash above the order is reduced once
+        uint8_t hash[32];
+        if (i % 10 == 0)
+        {
+            memset(hash, 0xff, sizeof(hash));
+        }
+        else
+        {
+            esp_fill_random(hash, sizeof(hash));
+        }
+
+        uint8_t signature[64];
+
+        auto start = std::chrono::steady_clock::now();
+        uECC_sign(privateKey.key, hash, sizeof(hash), signature, Crypto::ECDSA::_es256_curve);
+        baseline.push_back(elapsedSince(start));
+
+        start = std::chrono::steady_clock::now();
+        const bool success = Crypto::ECDSA::sign(&privateKey, hash, signature);
+        samples.push_back(elapsedSince(start));
+
+        if (!success || !uECC_verify((const uint8_t *)&publicKey, hash, sizeof(hash), signature, Crypto::ECDSA::_es256_curve))
+        {
+            failures++;
+        }
+    }
+
+    printf("# signature, %u hashes\n", ITERATIONS);
+    printLatency("micro-ecc", baseline);
+    printLatency("comb", samples);
+    printSpeedup(baseline, samples);
+    printf(" * failed: %u\n", failures);
+
+    return failures;
+}
+
+int main()
+{
+    // the micro-ecc signatures need a source of randomness
+    uECC_set_rng(randomBytes);
+
+    printf("## P-256 comb against micro-ecc\n");
+
+    const uint32_t mismatches = runPublicKeys();
+    const uint32_t failures = runSignatures();
+
+    return mismatches == 0 && failures == 0 ? 0 : 1;
+}
\ No newline at end of file
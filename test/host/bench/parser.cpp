@@ -0,0 +1,194 @@
+#include <Arduino.h>
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "fido2/ctap/ctap.h"
+#include "util/arena.h"
+
+#include "stats.h"
+
+/**
+ * Parser throughput over the benchmark corpus and over malformed variants of it, measured on the host.
+ * Heap allocations are counted by replacing the global operator new, the run fails when a request of the
+ * corpus is rejected or any request allocates on the heap, the parsed requests are views into the message.
+ */
+
+#define ITERATIONS 2000
+#define MUTATIONS 300
+#define ARENA_SIZE 1024
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        abort();
+    }
+
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+alignas(8) static uint8_t arenaBuffer[ARENA_SIZE];
+
+/**
+ * @return true if every request was parsed without heap allocations
+ */
+static bool runValid(const std::vector<Benchmark::CorpusEntry> &corpus)
+{
+    std::vector<uint32_t> samples;
+    samples.reserve(ITERATIONS);
+
+    uint32_t failed = 0;
+    size_t allocated = 0;
+
+    printf("## CTAP request parsing, %u iterations\n", ITERATIONS);
+
+    for (const Benchmark::CorpusEntry &entry : corpus)
+    {
+        Arena arena(arenaBuffer, sizeof(arenaBuffer));
+
+        samples.clear();
+        uint32_t failures = 0;
+        size_t maxAllocations = 0;
+        uint64_t total = 0;
+
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            const size_t before = allocations;
+
+            const auto start = std::chrono::steady_clock::now();
+            FIDO2::CTAP::Command *command = nullptr;
+            FIDO2::CTAP::Status status = FIDO2::CTAP::Request::parse(entry.request.data(), entry.request.size(), arena, &command);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            maxAllocations = std::max(maxAllocations, allocations - before);
+            arena.reset();
+
+            samples.push_back(elapsed);
+            total += elapsed;
+
+            if (status != FIDO2::CTAP::CTAP2_OK)
+            {
+                failures++;
+            }
+        }
+
+        printf("# %s %u, %zu bytes\n", entry.name, entry.parameter, entry.request.size());
+        printf(" * single pass: p50 %u ns, p90 %u ns, p99 %u ns\n", percentile(samples, 50), percentile(samples, 90), percentile(samples, 99));
+        printf(" * throughput: %llu requests/s\n", (unsigned long long)(ITERATIONS * 1000000000ULL / std::max<uint64_t>(total, 1)));
+        printf(" * heap allocations per request: %zu\n", maxAllocations);
+        printf(" * arena per request: %zu bytes\n", arena.getPeak());
+        printf(" * failed: %u\n", failures);
+
+        failed += failures;
+        allocated += maxAllocations;
+    }
+
+    return failed == 0 && allocated == 0;
+}
+
+/**
+ * Error path of the parser, the same mutations as in the device benchmark: every request is truncated at a
+ * random position, has random bytes replaced or a random byte inserted.
+ *
+ * @return true if no status disagrees with the returned command and no rejected request allocated
+ */
+static bool runMalformed(const std::vector<Benchmark::CorpusEntry> &corpus)
+{
+    std::vector<uint8_t> malformed;
+    std::vector<uint32_t> samples;
+    samples.reserve(corpus.size() * MUTATIONS);
+
+    uint32_t rejected = 0;
+    uint32_t inconsistent = 0;
+    size_t maxAllocations = 0;
+    uint64_t total = 0;
+
+    Arena arena(arenaBuffer, sizeof(arenaBuffer));
+
+    for (const Benchmark::CorpusEntry &entry : corpus)
+    {
+        for (auto i = 0; i < MUTATIONS; i++)
+        {
+            malformed = entry.request;
+            const size_t position = 1 + esp_random() % (malformed.size() - 1);
+            switch (i % 3)
+            {
+            case 0:
+                malformed.resize(position);
+                break;
+            case 1:
+                for (auto j = esp_random() % 4; j < 4; j++)
+                {
+                    malformed[1 + esp_random() % (malformed.size() - 1)] = esp_random() & 0xff;
+                }
+                break;
+            default:
+                malformed.insert(malformed.begin() + position, esp_random() & 0xff);
+                break;
+            }
+
+            const size_t before = allocations;
+
+            const auto start = std::chrono::steady_clock::now();
+            FIDO2::CTAP::Command *command = nullptr;
+            FIDO2::CTAP::Status status = FIDO2::CTAP::Request::parse(malformed.data(), malformed.size(), arena, &command);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            arena.reset();
+
+            samples.push_back(elapsed);
+            total += elapsed;
+
+            if (status != FIDO2::CTAP::CTAP2_OK)
+            {
+                rejected++;
+                maxAllocations = std::max(maxAllocations, allocations - before);
+            }
+            if ((status == FIDO2::CTAP::CTAP2_OK) != (command != nullptr))
+            {
+                inconsistent++;
+            }
+        }
+    }
+
+    printf("# malformed requests, %u mutations of every request\n", MUTATIONS);
+    printf(" * single pass: p50 %u ns, p90 %u ns, p99 %u ns\n", percentile(samples, 50), percentile(samples, 90), percentile(samples, 99));
+    printf(" * throughput: %llu requests/s\n", (unsigned long long)(samples.size() * 1000000000ULL / std::max<uint64_t>(total, 1)));
+    printf(" * rejected: %u of %zu\n", rejected, samples.size());
+    printf(" * heap allocations per rejected request: %zu\n", maxAllocations);
+    printf(" * inconsistent: %u\n", inconsistent);
+
+    return inconsistent == 0 && maxAllocations == 0;
+}
+
+int main()
+{
+    std::vector<Benchmark::CorpusEntry> corpus;
+    Benchmark::buildCorpus(corpus);
+
+    const bool valid = runValid(corpus);
+    const bool malformed = runMalformed(corpus);
+
+    return valid && malformed ? 0 : 1;
+}
\ No newline at end of file
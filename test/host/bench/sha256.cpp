@@ -0,0 +1,156 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "fido2/ctap/ctap.h"
+
+#include "atecc.h"
+#include "stats.h"
+
+/**
+ * SHA-256 of the data hashed per request on every backend, with the secure element emulated by its latency
+ * model. Public data is routed to the software backend on the host, the SHA accelerator of the ESP32 used by
+ * mbedtls is measured on the device only. The run fails when a backend or the routed hash disagrees with the
+ * software digest, or the software digest is not SHA-256.
+ */
+
+#define ITERATIONS 20
+
+// the software hashes take less than a microsecond on the host, the samples are taken in nanoseconds
+static uint32_t elapsedSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printLatency(const char *name, std::vector<uint32_t> &samples)
+{
+    const uint32_t p50 = percentile(samples, 50);
+    const uint32_t p90 = percentile(samples, 90);
+    const uint32_t p99 = percentile(samples, 99);
+    printf(" * %s: p50 %u.%03u us, p90 %u.%03u us, p99 %u.%03u us\n", name, p50 / 1000, p50 % 1000, p90 / 1000, p90 % 1000, p99 / 1000, p99 % 1000);
+}
+
+/**
+ * Digest of "abc" from FIPS 180-2
+ */
+static bool checkSoftware()
+{
+    static const uint8_t expected[32] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+
+    uint8_t sha[32];
+    return Crypto::SHA256::hashSoftware((const uint8_t *)"abc", 3, sha) && memcmp(sha, expected, sizeof(sha)) == 0;
+}
+
+int main()
+{
+    const size_t assertionSize = sizeof(FIDO2::CTAP::AuthenticatorData) - sizeof(FIDO2::CTAP::AttestedCredentialData) + 32;
+    const struct
+    {
+        const char *name;
+        size_t length;
+    } inputs[] = {
+        {"rpId", 11},
+        {"assertion", assertionSize},
+        {"attestation", sizeof(FIDO2::CTAP::AuthenticatorData) + 32},
+    };
+
+    const struct
+    {
+        const char *name;
+        bool (*hash)(const uint8_t *data, const size_t length, uint8_t *sha);
+    } backends[] = {
+        {"software", Crypto::SHA256::hashSoftware},
+        {"mbedtls", Crypto::SHA256::hashMbedTLS},
+        {"secure element (emulated)", Crypto::SHA256::hashSecureElement},
+        {"routed", Crypto::SHA256::hash},
+    };
+
+    if (!checkSoftware())
+    {
+        printf("! the software backend does not compute SHA-256\n");
+        return 1;
+    }
+
+    printf("## SHA-256, %u iterations\n", ITERATIONS);
+
+    uint8_t data[sizeof(FIDO2::CTAP::AuthenticatorData) + 32];
+    esp_fill_random(data, sizeof(data));
+
+    std::vector<uint32_t> samples;
+    samples.reserve(ITERATIONS);
+
+    uint32_t mismatches = 0;
+
+    for (auto input : inputs)
+    {
+        printf("# %s, %zu bytes\n", input.name, input.length);
+
+        uint8_t expected[32];
+        Crypto::SHA256::hashSoftware(data, input.length, expected);
+
+        std::vector<uint32_t> routed;
+
+        for (auto backend : backends)
+        {
+            samples.clear();
+            bool available = true;
+            for (auto i = 0; i < ITERATIONS && available; i++)
+            {
+                uint8_t sha[32];
+                const auto start = std::chrono::steady_clock::now();
+                available = backend.hash(data, input.length, sha);
+                samples.push_back(elapsedSince(start));
+
+                if (available && memcmp(sha, expected, sizeof(sha)) != 0)
+                {
+                    mismatches++;
+                }
+            }
+
+            if (!available)
+            {
+                printf(" * %s: not available on the host\n", backend.name);
+                continue;
+            }
+
+            printLatency(backend.name, samples);
+            if (backend.hash == Crypto::SHA256::hash)
+            {
+                routed = samples;
+            }
+        }
+
+        // the routed backend fed in two pieces, as the signed data is
+        samples.clear();
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            const size_t half = input.length / 2;
+            uint8_t sha[32];
+            const auto start = std::chrono::steady_clock::now();
+            Crypto::SHA256::Context sha256;
+            sha256.init();
+            sha256.update(data, half);
+            sha256.update(data + half, input.length - half);
+            const bool success = sha256.finalize(sha);
+            samples.push_back(elapsedSince(start));
+
+            if (!success || memcmp(sha, expected, sizeof(sha)) != 0)
+            {
+                mismatches++;
+            }
+        }
+        printLatency("streamed", samples);
+
+        const uint32_t model = modelSecureElement(input.length);
+        printf(" * secure element (model): %u us\n", model);
+        printf(" * routed instead of the secure element: %u us saved per hash\n", model - std::min(model, percentile(routed, 50) / 1000));
+    }
+
+    printf(" * mismatches: %u\n", mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
\ No newline at end of file
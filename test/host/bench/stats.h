@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Value below which the given percent of the samples fall
+ */
+inline uint32_t percentile(std::vector<uint32_t> &samples, const uint8_t percent)
+{
+    if (samples.empty())
+    {
+        return 0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    return samples[(samples.size() - 1) * percent / 100];
+}
\ No newline at end of file
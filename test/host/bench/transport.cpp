@@ -0,0 +1,147 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "../transport/harness.h"
+#include "stats.h"
+
+/**
+ * Round trips of the benchmark corpus through the control point: every request is sent as a ping, so it is
+ * reassembled by the control point and its echo fragmented into notifications. Lost and reordered request
+ * fragments are answered with an error or not at all, the client then sends the whole request again.
+ * Notifications refused by the stack are retried by the notification sender.
+ */
+
+#define ITERATIONS 20
+#define MAX_ATTEMPTS 5
+#define TIMEOUT_MS 50
+
+#define CMD_PING 0x81
+
+struct Scenario
+{
+    uint16_t fragmentSize;
+    // percent of the request fragments
+    uint8_t loss;
+    uint8_t reordering;
+    // percent of the notifications
+    uint8_t refusal;
+};
+
+static const Scenario scenarios[] = {
+    {20, 0, 0, 0},
+    {64, 0, 0, 0},
+    {182, 0, 0, 0},
+    {244, 0, 0, 0},
+    {512, 0, 0, 0},
+    {64, 1, 0, 0},
+    {64, 0, 1, 0},
+    {64, 5, 5, 0},
+    {244, 5, 5, 0},
+    {64, 0, 0, 5},
+    {244, 0, 0, 5},
+};
+
+/**
+ * @return number of attempts or 0 if the echo was not received
+ */
+static uint8_t exchange(Host::Client &client, const std::vector<uint8_t> &request, uint32_t *fragments)
+{
+    for (uint8_t attempt = 1; attempt <= MAX_ATTEMPTS; attempt++)
+    {
+        client.clear();
+        *fragments += client.write(CMD_PING, request.data(), request.size());
+
+        Host::Frame frame;
+        if (client.read(frame, TIMEOUT_MS) && frame.cmd == CMD_PING && frame.payload == request)
+        {
+            return attempt;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    // the transport logs every request and response
+    Serial.enabled = false;
+
+    std::vector<Benchmark::CorpusEntry> corpus;
+    Benchmark::buildCorpus(corpus);
+
+    uint32_t lostWithoutLoss = 0;
+
+    Host::Client client;
+
+    printf("## BLE transport round trips, %u iterations of %zu requests\n", ITERATIONS, corpus.size());
+
+    for (const Scenario &scenario : scenarios)
+    {
+        client.setFragmentSize(scenario.fragmentSize);
+        client.setLoss(scenario.loss);
+        client.setReordering(scenario.reordering);
+        client.setRefusal(scenario.refusal);
+
+        std::vector<uint32_t> latencies;
+        uint32_t messages = 0;
+        uint32_t failures = 0;
+        uint32_t retries = 0;
+        uint32_t fragments = 0;
+        uint32_t refusals = 0;
+        uint64_t bytes = 0;
+        int64_t duration = 0;
+
+        for (auto i = 0; i < ITERATIONS; i++)
+        {
+            for (const Benchmark::CorpusEntry &entry : corpus)
+            {
+                if (entry.request.size() > FIDO2_MAX_MSG_SIZE - 3)
+                {
+                    continue;
+                }
+
+                const uint32_t notifications = client.getNotifications();
+                const uint32_t refused = client.getRefused();
+
+                const int64_t start = esp_timer_get_time();
+                const uint8_t attempts = exchange(client, entry.request, &fragments);
+                const int64_t elapsed = esp_timer_get_time() - start;
+
+                fragments += client.getNotifications() - notifications;
+                refusals += client.getRefused() - refused;
+                messages++;
+
+                if (attempts == 0)
+                {
+                    failures++;
+                    retries += MAX_ATTEMPTS - 1;
+                    continue;
+                }
+
+                retries += attempts - 1;
+                bytes += 2 * entry.request.size();
+                duration += elapsed;
+                latencies.push_back(elapsed);
+            }
+        }
+
+        if (scenario.loss == 0 && scenario.reordering == 0 && scenario.refusal == 0)
+        {
+            lostWithoutLoss += failures + retries;
+        }
+
+        printf("# fragment %u bytes, loss %u%%, reordering %u%%, refusal %u%%\n", scenario.fragmentSize, scenario.loss, scenario.reordering, scenario.refusal);
+        printf(" * messages: %u, failed: %u, retries: %u, refused notifications: %u\n", messages, failures, retries, refusals);
+        printf(" * fragments per message: %u.%02u\n", fragments / messages, (fragments * 100 / messages) % 100);
+        printf(" * throughput: %lu KB/s\n", duration > 0 ? (unsigned long)(bytes * 1000000 / duration / 1024) : 0);
+        printf(" * latency: p50 %u us, p90 %u us, p99 %u us\n", percentile(latencies, 50), percentile(latencies, 90), percentile(latencies, 99));
+    }
+
+    // a lossless link must not need any retries
+    return lostWithoutLoss == 0 ? 0 : 1;
+}
\ No newline at end of file
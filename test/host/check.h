@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define CHECK(condition)                                                      \
+    do                                                                        \
+    {                                                                         \
+        checks++;                                                             \
+        if (!(condition))                                                     \
+        {                                                                     \
+            failures++;                                                       \
+            fprintf(stderr, "! %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        }                                                                     \
+    } while (0)
+
+// counters of the host tests, the test fails when any check fails
+extern uint32_t checks;
+extern uint32_t failures;
\ No newline at end of file
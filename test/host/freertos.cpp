@@ -0,0 +1,277 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * FreeRTOS primitives used by the BLE transport, backed by threads of the host process.
+ * Tasks and timers run until the process exits.
+ */
+
+int64_t esp_timer_get_time()
+{
+    return micros();
+}
+
+static std::chrono::milliseconds toDuration(const TickType_t ticks)
+{
+    return std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+}
+
+static std::recursive_mutex critical;
+
+void hostEnterCritical()
+{
+    critical.lock();
+}
+
+void hostExitCritical()
+{
+    critical.unlock();
+}
+
+struct HostSemaphore
+{
+    std::timed_mutex mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new HostSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+
+    return semaphore->mutex.try_lock_for(toDuration(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->mutex.unlock();
+
+    return pdTRUE;
+}
+
+struct HostEventGroup
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate()
+{
+    return new HostEventGroup();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, const EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+    group->bits |= bits;
+    group->changed.notify_all();
+
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, const EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+    const EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+
+    return previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, const EventBits_t bits, const BaseType_t clearOnExit, const BaseType_t waitForAllBits, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(group->mutex);
+
+    auto satisfied = [&] {
+        return waitForAllBits ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+
+    if (ticks == portMAX_DELAY)
+    {
+        group->changed.wait(lock, satisfied);
+    }
+    else
+    {
+        group->changed.wait_for(lock, toDuration(ticks), satisfied);
+    }
+
+    const EventBits_t result = group->bits;
+    if (clearOnExit && satisfied())
+    {
+        group->bits &= ~bits;
+    }
+
+    return result;
+}
+
+struct HostQueue
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(const UBaseType_t length, const UBaseType_t itemSize)
+{
+    HostQueue *queue = new HostQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    auto free = [&] { return queue->items.size() < queue->length; };
+
+    if (ticks == portMAX_DELAY)
+    {
+        queue->changed.wait(lock, free);
+    }
+    else if (!queue->changed.wait_for(lock, toDuration(ticks), free))
+    {
+        return pdFALSE;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    auto available = [&] { return !queue->items.empty(); };
+
+    if (ticks == portMAX_DELAY)
+    {
+        queue->changed.wait(lock, available);
+    }
+    else if (!queue->changed.wait_for(lock, toDuration(ticks), available))
+    {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->changed.notify_all();
+
+    return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, const uint32_t stackDepth, void *parameters, UBaseType_t priority, TaskHandle_t *handle)
+{
+    std::thread(function, parameters).detach();
+
+    // the handle is only compared against NULL
+    if (handle != nullptr)
+    {
+        *handle = (TaskHandle_t)1;
+    }
+
+    return pdPASS;
+}
+
+void vTaskDelay(const TickType_t ticks)
+{
+    std::this_thread::sleep_for(toDuration(ticks));
+}
+
+/**
+ * Each timer has its own thread, the callback is called without holding the lock
+ */
+struct HostTimer
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    TickType_t period;
+    bool autoReload;
+    TimerCallbackFunction_t callback;
+    bool running = false;
+    // incremented by every start and stop, so a pending expiry of the previous period is discarded
+    uint32_t generation = 0;
+};
+
+static void timerThread(HostTimer *timer)
+{
+    std::unique_lock<std::mutex> lock(timer->mutex);
+
+    while (true)
+    {
+        timer->changed.wait(lock, [&] { return timer->running; });
+
+        const uint32_t generation = timer->generation;
+        if (timer->changed.wait_for(lock, toDuration(timer->period), [&] { return timer->generation != generation; }))
+        {
+            continue;
+        }
+
+        timer->running = timer->autoReload;
+
+        lock.unlock();
+        timer->callback(timer);
+        lock.lock();
+    }
+}
+
+TimerHandle_t xTimerCreate(const char *name, const TickType_t period, const UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback)
+{
+    HostTimer *timer = new HostTimer();
+    timer->period = period;
+    timer->autoReload = autoReload;
+    timer->callback = callback;
+
+    std::thread(timerThread, timer).detach();
+
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks)
+{
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->running = true;
+    timer->generation++;
+    timer->changed.notify_all();
+
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks)
+{
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->running = false;
+    timer->generation++;
+    timer->changed.notify_all();
+
+    return pdPASS;
+}
\ No newline at end of file
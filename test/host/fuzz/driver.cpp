@@ -0,0 +1,107 @@
+#include <Arduino.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+/**
+ * Runs a fuzz target without libFuzzer, when the compiler does not provide it.
+ * The inputs given on the command line are run once, a crash found by libFuzzer can be reproduced this way.
+ * Without arguments the parameters of every request of the benchmark corpus are run as they are, truncated,
+ * with random bytes replaced and with a random byte inserted.
+ */
+
+#define MUTATIONS 5000
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static bool readFile(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t buffer[256];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + length);
+    }
+    fclose(file);
+
+    return true;
+}
+
+static void mutate(std::vector<uint8_t> &data, const uint32_t round)
+{
+    const size_t position = data.empty() ? 0 : esp_random() % data.size();
+    switch (round % 3)
+    {
+    case 0:
+        data.resize(position);
+        break;
+    case 1:
+        for (auto i = esp_random() % 4; i < 4 && !data.empty(); i++)
+        {
+            data[esp_random() % data.size()] = esp_random() & 0xff;
+        }
+        break;
+    default:
+        data.insert(data.begin() + position, esp_random() & 0xff);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // the parser reports every rejected input with DEBUG_ERRORS
+    Serial.enabled = false;
+
+    uint32_t inputs = 0;
+
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::vector<uint8_t> data;
+            if (!readFile(argv[i], data))
+            {
+                fprintf(stderr, "! Cannot read %s\n", argv[i]);
+                return 1;
+            }
+
+            LLVMFuzzerTestOneInput(data.data(), data.size());
+            inputs++;
+        }
+    }
+    else
+    {
+        std::vector<Benchmark::CorpusEntry> corpus;
+        Benchmark::buildCorpus(corpus);
+
+        std::vector<uint8_t> data;
+        for (const Benchmark::CorpusEntry &entry : corpus)
+        {
+            // the target supplies the command byte
+            const std::vector<uint8_t> parameters(entry.request.begin() + 1, entry.request.end());
+
+            LLVMFuzzerTestOneInput(parameters.data(), parameters.size());
+            inputs++;
+
+            for (uint32_t round = 0; round < MUTATIONS; round++)
+            {
+                data = parameters;
+                mutate(data, round);
+
+                LLVMFuzzerTestOneInput(data.data(), data.size());
+                inputs++;
+            }
+        }
+    }
+
+    printf("# %u inputs run\n", inputs);
+
+    return 0;
+}
\ No newline at end of file
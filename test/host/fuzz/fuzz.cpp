@@ -0,0 +1,42 @@
+#include <stdlib.h>
+
+#include "fuzz.h"
+
+#include "util/arena.h"
+
+// same size as the transaction arena of the BLE transport
+#define ARENA_SIZE 1024
+
+alignas(8) static uint8_t arenaBuffer[ARENA_SIZE];
+static Arena arena(arenaBuffer, sizeof(arenaBuffer));
+
+static uint8_t message[FIDO2_MAX_MSG_SIZE];
+
+int fuzzRequest(const FIDO2::CTAP::CommandCode command, const uint8_t *data, const size_t size)
+{
+    // longer messages are rejected by the transport
+    if (size > sizeof(message) - 1)
+    {
+        return 0;
+    }
+
+    message[0] = command;
+    memcpy(message + 1, data, size);
+
+    FIDO2::CTAP::Command *request = nullptr;
+    FIDO2::CTAP::Status status = FIDO2::CTAP::Request::parse(message, size + 1, arena, &request);
+
+    if ((status == FIDO2::CTAP::CTAP2_OK) != (request != nullptr))
+    {
+        abort();
+    }
+
+    if (request != nullptr && request->getCommandCode() != command)
+    {
+        abort();
+    }
+
+    arena.reset();
+
+    return 0;
+}
\ No newline at end of file
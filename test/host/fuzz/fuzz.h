@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "fido2/ctap/ctap.h"
+
+/**
+ * Parse the input as the parameters of the given command, the way the transport passes a received message.
+ * Aborts when the parser breaks its contract: a request is returned exactly when the status is CTAP2_OK,
+ * and it is a request of the given command.
+ */
+int fuzzRequest(const FIDO2::CTAP::CommandCode command, const uint8_t *data, const size_t size);
\ No newline at end of file
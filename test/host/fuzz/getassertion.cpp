@@ -0,0 +1,6 @@
+#include "fuzz.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    return fuzzRequest(FIDO2::CTAP::authenticatorGetAssertion, data, size);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <thread>
+
+#include "fido2/authenticator/authenticator.h"
+
+HostSerial Serial;
+
+// every thread has its own sequence, the transport calls it from the worker and the timer threads as well
+static thread_local uint32_t randomState = 0x2545f491;
+
+uint32_t esp_random()
+{
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return randomState;
+}
+
+void esp_fill_random(void *buffer, size_t length)
+{
+    uint8_t *bytes = (uint8_t *)buffer;
+    for (size_t i = 0; i < length; i++)
+    {
+        bytes[i] = esp_random() & 0xff;
+    }
+}
+
+unsigned long micros()
+{
+    static const auto start = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+namespace FIDO2
+{
+    namespace Authenticator
+    {
+        // the attestation certificate is encoded as is, its content does not matter to the encoder
+        const uint8_t certificate[] = {0x30, 0x00};
+        const size_t certificateSize = sizeof(certificate);
+    } // namespace Authenticator
+} // namespace FIDO2
\ No newline at end of file
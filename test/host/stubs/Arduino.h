@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * Subset of the Arduino core used by the code built on the host
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <string.h>
+
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+
+class String
+{
+public:
+    String() {}
+    String(const char *str) : value(str) {}
+
+    const char *c_str() const { return value.c_str(); }
+    size_t length() const { return value.size(); }
+    unsigned char reserve(unsigned int size)
+    {
+        value.reserve(size);
+        return 1;
+    }
+
+    String &operator+=(const char c)
+    {
+        value += c;
+        return *this;
+    }
+
+    bool operator==(const String &other) const { return value == other.value; }
+
+private:
+    std::string value;
+};
+
+/**
+ * Console output goes to stdout, it can be silenced so the output does not distort the measurements
+ */
+class HostSerial
+{
+public:
+    int printf(const char *format, ...)
+    {
+        if (!enabled)
+        {
+            return 0;
+        }
+
+        va_list args;
+        va_start(args, format);
+        const int written = vprintf(format, args);
+        va_end(args);
+
+        return written;
+    }
+
+    void print(const char *str) { printf("%s", str); }
+    void println(const char *str = "") { printf("%s\n", str); }
+    void println(const String &str) { println(str.c_str()); }
+
+    // no console input on the host
+    int available() { return 0; }
+    int read() { return -1; }
+
+    bool enabled = true;
+};
+
+extern HostSerial Serial;
+
+// deterministic, so the host runs are reproducible
+uint32_t esp_random();
+void esp_fill_random(void *buffer, size_t length);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "BLECharacteristic.h"
+
+class BLE2902 : public BLEDescriptor
+{
+};
\ No newline at end of file
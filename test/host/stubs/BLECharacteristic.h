@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+#include <vector>
+
+#include "BLEUUID.h"
+
+class BLECharacteristic;
+
+class BLEDescriptor
+{
+public:
+    virtual ~BLEDescriptor() {}
+};
+
+class BLECharacteristicCallbacks
+{
+public:
+    typedef enum
+    {
+        SUCCESS_INDICATE,
+        SUCCESS_NOTIFY,
+        ERROR_INDICATE_DISABLED,
+        ERROR_NOTIFY_DISABLED,
+        ERROR_GATT,
+        ERROR_NO_CLIENT,
+        ERROR_INDICATE_TIMEOUT,
+        ERROR_INDICATE_FAILURE
+    } Status;
+
+    virtual ~BLECharacteristicCallbacks() {}
+
+    virtual void onRead(BLECharacteristic *pCharacteristic) {}
+    virtual void onWrite(BLECharacteristic *pCharacteristic) {}
+    virtual void onNotify(BLECharacteristic *pCharacteristic) {}
+    virtual void onStatus(BLECharacteristic *pCharacteristic, Status s, uint32_t code) {}
+};
+
+/**
+ * Characteristic simulated on the host. A notification is handed to the transmit handler, which stands in
+ * for the BLE stack and the client. Its result is reported through onStatus() before notify() returns,
+ * the way the Bluedroid stack reports it.
+ */
+class BLECharacteristic
+{
+public:
+    static const uint32_t PROPERTY_READ = 1 << 0;
+    static const uint32_t PROPERTY_WRITE = 1 << 1;
+    static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+
+    typedef std::function<BLECharacteristicCallbacks::Status(const uint8_t *data, size_t length)> TransmitHandler;
+
+    BLECharacteristic(BLEUUID uuid = BLEUUID((uint16_t)0), uint32_t properties = 0) {}
+
+    void setCallbacks(BLECharacteristicCallbacks *callbacks) { this->callbacks = callbacks; }
+    void addDescriptor(BLEDescriptor *descriptor) {}
+
+    void setValue(uint8_t *data, size_t length) { value.assign(data, data + length); }
+    uint8_t *getData() { return value.data(); }
+    size_t getLength() { return value.size(); }
+
+    void notify(bool is_notification = true)
+    {
+        const BLECharacteristicCallbacks::Status status = transmit ? transmit(value.data(), value.size()) : BLECharacteristicCallbacks::ERROR_NO_CLIENT;
+        if (callbacks != nullptr)
+        {
+            callbacks->onStatus(this, status, 0);
+        }
+    }
+
+    // host only
+    void setTransmitHandler(TransmitHandler handler) { transmit = handler; }
+
+private:
+    BLECharacteristicCallbacks *callbacks = nullptr;
+    std::vector<uint8_t> value;
+    TransmitHandler transmit;
+};
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "BLEServer.h"
+
+typedef void (*gatts_event_handler)(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param);
+
+class BLEDevice
+{
+public:
+    static void setCustomGattsHandler(gatts_event_handler handler) {}
+};
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_gatts_api.h"
+#include "BLEService.h"
+
+class BLEServer;
+
+class BLEServerCallbacks
+{
+public:
+    virtual ~BLEServerCallbacks() {}
+
+    virtual void onConnect(BLEServer *pServer) {}
+    virtual void onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param) {}
+    virtual void onDisconnect(BLEServer *pServer) {}
+};
+
+/**
+ * Server with a single simulated connection, the peer MTU is set by the host harness
+ */
+class BLEServer
+{
+public:
+    BLEService *createService(BLEUUID uuid) { return new BLEService(); }
+
+    uint16_t getConnId() { return 0; }
+    uint16_t getPeerMTU(uint16_t connId) { return mtu; }
+    uint32_t getConnectedCount() { return connected; }
+    void updateConnParams(esp_bd_addr_t remote_bda, uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout) {}
+
+    // host only
+    uint16_t mtu = 23;
+    uint32_t connected = 0;
+};
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "BLECharacteristic.h"
+
+class BLEService
+{
+public:
+    BLECharacteristic *createCharacteristic(BLEUUID uuid, uint32_t properties) { return new BLECharacteristic(uuid, properties); }
+    void start() {}
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+class BLEUUID
+{
+public:
+    BLEUUID(const uint16_t uuid) : value(std::to_string(uuid)) {}
+    BLEUUID(const char *uuid) : value(uuid) {}
+
+    std::string toString() const { return value; }
+
+private:
+    std::string value;
+};
\ No newline at end of file
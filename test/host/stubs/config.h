@@ -0,0 +1,19 @@
+#pragma once
+
+// the host build uses the device configuration with the benchmark corpus and the fragment capture
+#include "../../../include/config.h.example"
+
+#ifndef BENCHMARK_ENABLED
+#define BENCHMARK_ENABLED
+#endif
+
+#ifndef FIDO2_CAPTURE_ENABLED
+#define FIDO2_CAPTURE_ENABLED
+#endif
+
+// the SHA-256 benchmark routes the public data to the software backend, the SHA accelerator of the ESP32 is
+// not there
+#ifdef HOST_SHA256_BACKEND
+#undef SHA256_BACKEND
+#define SHA256_BACKEND HOST_SHA256_BACKEND
+#endif
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef uint8_t esp_bd_addr_t[6];
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_bt_defs.h"
+
+typedef enum
+{
+    ESP_GATTS_CONNECT_EVT = 14,
+    ESP_GATTS_DISCONNECT_EVT = 15,
+    ESP_GATTS_CONGEST_EVT = 24,
+} esp_gatts_cb_event_t;
+
+typedef uint8_t esp_gatt_if_t;
+
+typedef union
+{
+    struct gatts_connect_evt_param
+    {
+        uint16_t conn_id;
+        esp_bd_addr_t remote_bda;
+    } connect;
+
+    struct gatts_congest_evt_param
+    {
+        uint16_t conn_id;
+        bool congested;
+    } congest;
+} esp_ble_gatts_cb_param_t;
\ No newline at end of file
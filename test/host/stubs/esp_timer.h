@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// microseconds since the start of the process
+int64_t esp_timer_get_time();
\ No newline at end of file
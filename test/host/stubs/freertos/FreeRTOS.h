@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * Subset of the FreeRTOS API used by the BLE transport, implemented with threads in freertos.cpp.
+ * A tick is one millisecond.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t EventBits_t;
+
+typedef struct HostSemaphore *SemaphoreHandle_t;
+typedef struct HostEventGroup *EventGroupHandle_t;
+typedef struct HostQueue *QueueHandle_t;
+typedef struct HostTask *TaskHandle_t;
+typedef struct HostTimer *TimerHandle_t;
+
+typedef void (*TaskFunction_t)(void *);
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#define BIT0 0x00000001
+#define BIT1 0x00000002
+#define BIT2 0x00000004
+
+// the critical sections of all the muxes are serialized with a single lock
+typedef struct
+{
+    uint32_t owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void hostEnterCritical();
+void hostExitCritical();
+
+#define portENTER_CRITICAL(mux) ((void)(mux), hostEnterCritical())
+#define portEXIT_CRITICAL(mux) ((void)(mux), hostExitCritical())
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+EventGroupHandle_t xEventGroupCreate();
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, const EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, const EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, const EventBits_t bits, const BaseType_t clearOnExit, const BaseType_t waitForAllBits, TickType_t ticks);
+
+QueueHandle_t xQueueCreate(const UBaseType_t length, const UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, const uint32_t stackDepth, void *parameters, UBaseType_t priority, TaskHandle_t *handle);
+void vTaskDelay(const TickType_t ticks);
+
+TimerHandle_t xTimerCreate(const char *name, const TickType_t period, const UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks);
\ No newline at end of file
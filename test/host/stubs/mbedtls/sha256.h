@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// storage of Crypto::SHA256::Context, the hash is not computed on the host
+typedef struct
+{
+    uint32_t total[2];
+    uint32_t state[8];
+    unsigned char buffer[64];
+    int is224;
+} mbedtls_sha256_context;
+
+// there is no SHA accelerator on the host, the backend reports a failure
+inline int mbedtls_sha256_ret(const unsigned char *input, size_t ilen, unsigned char output[32], int is224)
+{
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+// the CTAP layer refers only to the curve type, the arithmetic is not built on the host
+struct uECC_Curve_t;
+typedef const struct uECC_Curve_t *uECC_Curve;
\ No newline at end of file
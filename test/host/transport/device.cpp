@@ -0,0 +1,64 @@
+#include <Arduino.h>
+
+#include "ble/connection.h"
+#include "ble/device.h"
+#include "fido2/authenticator/authenticator.h"
+
+#include "harness.h"
+
+/**
+ * BLE device and authenticator as seen by the transport, the CTAP requests are parsed but not executed
+ */
+
+static BLEServer hostServer;
+
+namespace BLE
+{
+    BLEServer *server = &hostServer;
+
+    namespace Connection
+    {
+        void beginTransaction()
+        {
+            Host::transactions++;
+        }
+        void endTransaction() {}
+    } // namespace Connection
+} // namespace BLE
+
+namespace Host
+{
+    volatile uint32_t processingTime = 0;
+    volatile uint32_t transactions = 0;
+} // namespace Host
+
+namespace FIDO2
+{
+    namespace Authenticator
+    {
+        static volatile Status status = STATUS_IDLE;
+
+        uint8_t getStatus()
+        {
+            return status;
+        }
+
+        /**
+         * Successful empty response unless the request is cancelled before the processing time elapses
+         */
+        FIDO2::CTAP::Status processRequest(const FIDO2::CTAP::Command *request, Arena &arena, FIDO2::CTAP::Command **response, const CancellationToken &token)
+        {
+            status = STATUS_PROCESSING;
+
+            const unsigned long start = millis();
+            while (!token.isCancelled() && millis() - start < Host::processingTime)
+            {
+                delay(1);
+            }
+
+            status = STATUS_IDLE;
+
+            return token.isCancelled() ? FIDO2::CTAP::CTAP2_ERR_KEEPALIVE_CANCEL : FIDO2::CTAP::CTAP2_OK;
+        }
+    } // namespace Authenticator
+} // namespace FIDO2
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "harness.h"
+
+#include "ble/device.h"
+#include "fido2/transport/ble/sender.h"
+
+using namespace FIDO2::Transport::BLE;
+
+namespace Host
+{
+    static ControlPoint controlPoint;
+    static BLECharacteristic statusCharacteristic;
+    static Status statusCallbacks;
+
+    static bool started = false;
+
+    Client::Client()
+    {
+        if (!started)
+        {
+            started = true;
+
+            statusCharacteristic.setCallbacks(&statusCallbacks);
+            notificationSender.init(&statusCharacteristic);
+            workerStart(&controlPoint);
+            keepaliveInit();
+        }
+
+        ::BLE::server->connected = 1;
+        setFragmentSize(fragmentSize);
+
+        statusCharacteristic.setTransmitHandler([this](const uint8_t *data, size_t length) {
+            return transmit(data, length);
+        });
+    }
+
+    Client::~Client()
+    {
+        ::BLE::server->connected = 0;
+        statusCharacteristic.setTransmitHandler(nullptr);
+    }
+
+    void Client::setFragmentSize(const uint16_t size)
+    {
+        fragmentSize = size;
+        ::BLE::server->mtu = size + 3;
+    }
+
+    static bool chance(const uint8_t percent)
+    {
+        return percent > 0 && (esp_random() % 100) < percent;
+    }
+
+    void Client::setLoss(const uint8_t percent)
+    {
+        loss = percent;
+    }
+
+    void Client::setReordering(const uint8_t percent)
+    {
+        reordering = percent;
+    }
+
+    void Client::setRefusal(const uint8_t percent)
+    {
+        refusal = percent;
+    }
+
+    uint16_t Client::write(const uint8_t cmd, const uint8_t *payload, const uint16_t length)
+    {
+        CommandBuffer frame;
+        frame.reset();
+        frame.setCmd(cmd);
+        if (length > 0)
+        {
+            memcpy(frame.getPayload(), payload, length);
+        }
+        frame.setPayloadLength(length);
+
+        uint8_t fragment[FIDO2_CONTROL_POINT_MAX_LENGTH];
+        uint8_t heldFragment[FIDO2_CONTROL_POINT_MAX_LENGTH];
+
+        uint16_t index = 0;
+        uint16_t size;
+        while ((size = frame.getFragment(index, fragmentSize, fragment)) > 0)
+        {
+            index++;
+
+            if (chance(loss))
+            {
+                continue;
+            }
+
+            // swap with the following fragment
+            uint16_t heldSize;
+            if (chance(reordering) && (heldSize = frame.getFragment(index, fragmentSize, heldFragment)) > 0)
+            {
+                index++;
+                writeFragment(heldFragment, heldSize);
+            }
+
+            writeFragment(fragment, size);
+        }
+
+        return index;
+    }
+
+    void Client::writeFragment(const uint8_t *data, const size_t length)
+    {
+        controlPoint.ingest(data, length);
+    }
+
+    /**
+     * Called by notify() on the thread of the sender
+     */
+    BLECharacteristicCallbacks::Status Client::transmit(const uint8_t *data, const size_t length)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // controller buffers exhausted, the sender tries again
+        if (chance(refusal))
+        {
+            refused++;
+            return BLECharacteristicCallbacks::ERROR_GATT;
+        }
+
+        notifications++;
+
+        if (data[0] & 0x80)
+        {
+            partial.cmd = data[0];
+            partial.payload.assign(data + 3, data + length);
+            expected = length >= 3 ? (data[1] << 8 | data[2]) : 0;
+            sequence = 0;
+        }
+        else if (data[0] == sequence && partial.cmd != 0)
+        {
+            partial.payload.insert(partial.payload.end(), data + 1, data + length);
+            sequence = (sequence + 1) & 0x7f;
+        }
+        else
+        {
+            // broken response, the request times out
+            partial.cmd = 0;
+            return BLECharacteristicCallbacks::SUCCESS_NOTIFY;
+        }
+
+        if (partial.payload.size() >= expected)
+        {
+            if (partial.cmd == 0x82)
+            {
+                keepalives++;
+            }
+            else
+            {
+                frames.push_back(partial);
+                received.notify_all();
+            }
+            partial.cmd = 0;
+        }
+
+        return BLECharacteristicCallbacks::SUCCESS_NOTIFY;
+    }
+
+    bool Client::read(Frame &frame, const uint32_t timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (!received.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return !frames.empty(); }))
+        {
+            return false;
+        }
+
+        frame = frames.front();
+        frames.pop_front();
+
+        return true;
+    }
+
+    void Client::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        frames.clear();
+        partial.cmd = 0;
+    }
+
+    uint32_t Client::getKeepalives()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return keepalives;
+    }
+
+    uint32_t Client::getNotifications()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return notifications;
+    }
+
+    uint32_t Client::getRefused()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return refused;
+    }
+
+    ControlPoint &Client::getControlPoint()
+    {
+        return controlPoint;
+    }
+} // namespace Host
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "fido2/transport/ble/service.h"
+
+namespace Host
+{
+    // time the simulated authenticator takes for a CTAP request, it polls the cancellation token meanwhile
+    extern volatile uint32_t processingTime;
+
+    // calls of BLE::Connection::beginTransaction, which raises the connection to the active interval
+    extern volatile uint32_t transactions;
+
+    struct Frame
+    {
+        uint8_t cmd = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    /**
+     * FIDO client connected to the control point over a simulated link.
+     * Requests are split into fragments of the control point length and written to ControlPoint::ingest from
+     * the calling thread, which stands in for the BLE stack task. Notifications of the fidoStatus
+     * characteristic are reassembled into frames, the keepalives are counted separately. Refused notifications
+     * are reported to the sender through onStatus() and do not reach the client.
+     * The control point, the worker and the keepalive timer are started by the first client.
+     */
+    class Client
+    {
+    public:
+        Client();
+        ~Client();
+
+        // the peer MTU is set to match, so the responses are fragmented the same way
+        void setFragmentSize(const uint16_t size);
+        // percentage of the fragments which are dropped or swapped with the following one
+        void setLoss(const uint8_t percent);
+        void setReordering(const uint8_t percent);
+        // percentage of the notifications the stack refuses with a transient error
+        void setRefusal(const uint8_t percent);
+
+        /**
+         * @return number of fragments the frame was split into
+         */
+        uint16_t write(const uint8_t cmd, const uint8_t *payload, const uint16_t length);
+        void writeFragment(const uint8_t *data, const size_t length);
+
+        // next frame other than a keepalive, false on timeout
+        bool read(Frame &frame, const uint32_t timeout);
+
+        // drop the received frames and the partial one
+        void clear();
+
+        uint32_t getKeepalives();
+        uint32_t getNotifications();
+        uint32_t getRefused();
+
+        FIDO2::Transport::BLE::ControlPoint &getControlPoint();
+
+    protected:
+        BLECharacteristicCallbacks::Status transmit(const uint8_t *data, const size_t length);
+
+        uint16_t fragmentSize = 20;
+        uint8_t loss = 0;
+        uint8_t reordering = 0;
+        uint8_t refusal = 0;
+
+        std::mutex mutex;
+        std::condition_variable received;
+        std::deque<Frame> frames;
+        Frame partial;
+        size_t expected = 0;
+        uint8_t sequence = 0;
+        uint32_t keepalives = 0;
+        uint32_t notifications = 0;
+        uint32_t refused = 0;
+    };
+} // namespace Host
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <Arduino.h>
+
+#include <esp_timer.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "fido2/transport/ble/capture.h"
+#include "util/util.h"
+
+#include "harness.h"
+
+/**
+ * Replays a capture dumped from the device over the serial console ('d' command) through the control point.
+ *
+ *   replay [-f] [-d] [-e] <capture>
+ *
+ * The inbound fragments are written with their original spacing unless -f is given, then the requests can
+ * follow each other faster than they are processed and be rejected as busy. The notifications of the
+ * replayed session are counted against the captured ones. With -d the capture of the replayed session is
+ * printed in the dump format, so both sessions can be compared line by line. With -e the replay fails unless
+ * it produces as many notifications as captured.
+ * Requests are parsed but not executed, the responses to CTAP messages carry only the status.
+ */
+
+#define MAX_LINE (2 * FIDO2_CONTROL_POINT_MAX_LENGTH + 32)
+#define IDLE_MS 500
+
+struct Record
+{
+    bool outbound;
+    uint32_t timestamp;
+    std::vector<uint8_t> data;
+};
+
+static int hexValue(const char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ * Lines have the format "<direction> <timestamp us> <hex data>", other lines of the console are skipped
+ */
+static bool parseLine(const char *line, Record &record)
+{
+    if (line[0] != '>' && line[0] != '<')
+    {
+        return false;
+    }
+    record.outbound = line[0] == '<';
+
+    char *end;
+    record.timestamp = strtoul(line + 1, &end, 10);
+    if (end == line + 1)
+    {
+        return false;
+    }
+
+    while (*end == ' ')
+    {
+        end++;
+    }
+
+    record.data.clear();
+    for (const char *p = end; hexValue(p[0]) >= 0 && hexValue(p[1]) >= 0; p += 2)
+    {
+        record.data.push_back(hexValue(p[0]) << 4 | hexValue(p[1]));
+    }
+
+    return !record.data.empty();
+}
+
+static bool readCapture(const char *path, std::vector<Record> &records)
+{
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    char line[MAX_LINE];
+    Record record;
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        if (parseLine(line, record))
+        {
+            records.push_back(record);
+        }
+    }
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    bool fast = false;
+    bool dump = false;
+    bool expect = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-f") == 0)
+        {
+            fast = true;
+        }
+        else if (strcmp(argv[i], "-d") == 0)
+        {
+            dump = true;
+        }
+        else if (strcmp(argv[i], "-e") == 0)
+        {
+            expect = true;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (path == nullptr)
+    {
+        fprintf(stderr, "Usage: %s [-f] [-d] [-e] <capture>\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Record> records;
+    if (!readCapture(path, records))
+    {
+        fprintf(stderr, "! Cannot read %s\n", path);
+        return 1;
+    }
+
+    // the fragments were at most as long as the control point length of the original connection
+    uint16_t fragmentSize = 20;
+    uint32_t inbound = 0;
+    uint32_t outbound = 0;
+    for (const Record &record : records)
+    {
+        fragmentSize = MAX(fragmentSize, (uint16_t)record.data.size());
+        record.outbound ? outbound++ : inbound++;
+    }
+
+    if (inbound == 0)
+    {
+        fprintf(stderr, "! No inbound fragments in %s\n", path);
+        return 1;
+    }
+
+    printf("# Replay: %u inbound and %u outbound fragments, control point length %u\n", inbound, outbound, fragmentSize);
+
+    // the transport logs every request and response
+    Serial.enabled = false;
+
+    Host::Client client;
+    client.setFragmentSize(fragmentSize);
+
+    FIDO2::Transport::BLE::captureClear();
+
+    const int64_t startedAt = esp_timer_get_time();
+    const uint32_t capturedAt = records.front().timestamp;
+    uint32_t capturedDuration = 0;
+
+    for (const Record &record : records)
+    {
+        // the timestamps wrap after ~71 minutes, the differences do not
+        capturedDuration = record.timestamp - capturedAt;
+
+        if (record.outbound)
+        {
+            continue;
+        }
+
+        if (!fast)
+        {
+            const int64_t due = startedAt + capturedDuration;
+            const int64_t now = esp_timer_get_time();
+            if (due > now)
+            {
+                delay((due - now) / 1000);
+            }
+        }
+
+        client.writeFragment(record.data.data(), record.data.size());
+    }
+
+    // wait for the responses of the last requests
+    const int64_t replayedAt = esp_timer_get_time();
+    uint32_t frames = 0;
+    Host::Frame frame;
+    while (client.read(frame, IDLE_MS))
+    {
+        frames++;
+    }
+    const uint32_t notifications = client.getNotifications();
+
+    printf("# Replay done: %u fragments in %lu us, captured in %lu us\n",
+           inbound, (unsigned long)(replayedAt - startedAt), (unsigned long)capturedDuration);
+    printf("# Notifications: %u replayed in %u frames, %u captured\n", notifications, frames, outbound);
+
+    if (dump)
+    {
+        Serial.enabled = true;
+        FIDO2::Transport::BLE::captureDump();
+    }
+
+    return !expect || notifications == outbound ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include <Arduino.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "fido2/transport/ble/sender.h"
+
+#include "../check.h"
+#include "harness.h"
+
+/**
+ * Notification sender against a characteristic which refuses notifications or a congested link.
+ * Responses are retried, the errors and keepalives sent from the BLE stack and timer callbacks never wait.
+ */
+
+using FIDO2::Transport::BLE::NotificationSender;
+using FIDO2::Transport::BLE::notificationSender;
+
+#define CMD_PING 0x81
+
+#define TIMEOUT_MS 1000
+
+uint32_t checks = 0;
+uint32_t failures = 0;
+
+static const uint8_t packet[4] = {0xbf, 0x00, 0x01, 0x7f};
+
+/**
+ * Responses arrive intact although the stack refuses a part of the notifications, a fragment is lost
+ * only when it is refused on all the attempts
+ */
+static void testRefusedNotifications()
+{
+    Host::Client client;
+    client.setFragmentSize(20);
+    client.setRefusal(10);
+
+    std::vector<uint8_t> payload(1000);
+    esp_fill_random(payload.data(), payload.size());
+
+    for (auto i = 0; i < 10; i++)
+    {
+        client.write(CMD_PING, payload.data(), payload.size());
+
+        Host::Frame frame;
+        CHECK(client.read(frame, TIMEOUT_MS));
+        CHECK(frame.cmd == CMD_PING && frame.payload == payload);
+    }
+
+    CHECK(client.getRefused() > 0);
+}
+
+/**
+ * send() gives up after the retries, trySend() after the first attempt
+ */
+static void testPersistentRefusal()
+{
+    Host::Client client;
+    client.setRefusal(100);
+
+    notificationSender.begin();
+    const unsigned long start = millis();
+    CHECK(!notificationSender.send(packet, sizeof(packet)));
+    const unsigned long elapsed = millis() - start;
+    const NotificationSender::Stats stats = notificationSender.end();
+
+    CHECK(stats.fragments == 0);
+    CHECK(stats.retries == 3);
+    CHECK(stats.failures == 1);
+    // increasing delays of 10, 20 and 30 ms between the attempts
+    CHECK(elapsed >= 60);
+
+    notificationSender.begin(0);
+    const unsigned long tryStart = millis();
+    CHECK(!notificationSender.trySend(packet, sizeof(packet)));
+    const unsigned long tryElapsed = millis() - tryStart;
+    const NotificationSender::Stats tryStats = notificationSender.end();
+
+    CHECK(tryStats.retries == 0);
+    CHECK(tryStats.failures == 1);
+    CHECK(tryElapsed < 5);
+    CHECK(client.getRefused() == 4 + 1);
+}
+
+/**
+ * A notification without a connected client is not retried
+ */
+static void testNoClient()
+{
+    {
+        Host::Client client;
+    }
+
+    notificationSender.begin();
+    CHECK(!notificationSender.send(packet, sizeof(packet)));
+    const NotificationSender::Stats stats = notificationSender.end();
+
+    CHECK(stats.retries == 0);
+    CHECK(stats.failures == 1);
+}
+
+/**
+ * send() waits until the link is no longer congested, trySend() drops the notification at once
+ */
+static void testCongestion()
+{
+    Host::Client client;
+
+    notificationSender.setCongested(true);
+
+    notificationSender.begin(0);
+    const uint32_t notifications = client.getNotifications();
+    const unsigned long tryStart = millis();
+    CHECK(!notificationSender.trySend(packet, sizeof(packet)));
+    CHECK(millis() - tryStart < 5);
+    CHECK(client.getNotifications() == notifications);
+    notificationSender.end();
+
+    std::thread relief([] {
+        delay(100);
+        notificationSender.setCongested(false);
+    });
+
+    notificationSender.begin();
+    const unsigned long start = millis();
+    CHECK(notificationSender.send(packet, sizeof(packet)));
+    const unsigned long elapsed = millis() - start;
+    const NotificationSender::Stats stats = notificationSender.end();
+
+    relief.join();
+
+    CHECK(elapsed >= 100 && elapsed < 500);
+    CHECK(stats.fragments == 1);
+    CHECK(stats.retries == 0);
+}
+
+/**
+ * Transport errors are sent from the BLE stack task, which also delivers the congestion events and
+ * must not wait for them or for a response being sent
+ */
+static void testErrorWithoutBlocking()
+{
+    Host::Client client;
+    client.setFragmentSize(20);
+
+    Host::processingTime = 1000;
+
+    // both receive buffers hold a request, the initialization fragment of a third one is answered with ERR_BUSY
+    const uint8_t request[] = {0x04};
+    client.write(0x83, request, sizeof(request));
+    delay(50);
+    client.write(0x83, request, sizeof(request));
+
+    const uint8_t ping[] = {CMD_PING, 0x00, 0x00};
+    Host::Frame frame;
+
+    notificationSender.setCongested(true);
+    unsigned long start = millis();
+    client.writeFragment(ping, sizeof(ping));
+    CHECK(millis() - start < 5);
+    CHECK(!client.read(frame, 100));
+    notificationSender.setCongested(false);
+
+    // the sender is held by the worker sending a response
+    std::atomic<bool> held(false);
+    std::atomic<bool> release(false);
+    std::thread worker([&] {
+        notificationSender.begin();
+        held = true;
+        while (!release)
+        {
+            delay(1);
+        }
+        notificationSender.end();
+    });
+    while (!held)
+    {
+        delay(1);
+    }
+
+    start = millis();
+    client.writeFragment(ping, sizeof(ping));
+    CHECK(millis() - start < 5);
+
+    release = true;
+    worker.join();
+
+    CHECK(!client.read(frame, 100));
+
+    // the link is usable again
+    client.writeFragment(ping, sizeof(ping));
+    CHECK(client.read(frame, TIMEOUT_MS));
+    CHECK(frame.cmd == 0xbf);
+
+    // the responses to both requests follow
+    CHECK(client.read(frame, 2 * Host::processingTime + TIMEOUT_MS) && frame.cmd == 0x83);
+    CHECK(client.read(frame, 2 * Host::processingTime + TIMEOUT_MS) && frame.cmd == 0x83);
+
+    Host::processingTime = 0;
+}
+
+/**
+ * Keepalives are skipped while the link is congested, the response waits for it
+ */
+static void testKeepaliveWithoutBlocking()
+{
+    Host::Client client;
+    client.setFragmentSize(64);
+
+    Host::processingTime = FIDO2_KEEPALIVE_INTERVAL * 2 + FIDO2_KEEPALIVE_INTERVAL / 2;
+
+    // empty authenticatorGetInfo request
+    const uint8_t request[] = {0x04};
+
+    notificationSender.setCongested(true);
+    std::thread relief([] {
+        delay(Host::processingTime + 100);
+        notificationSender.setCongested(false);
+    });
+
+    const uint32_t keepalives = client.getKeepalives();
+    client.write(0x83, request, sizeof(request));
+
+    Host::Frame frame;
+    CHECK(client.read(frame, Host::processingTime + TIMEOUT_MS));
+    CHECK(frame.cmd == 0x83);
+    CHECK(client.getKeepalives() == keepalives);
+
+    relief.join();
+
+    Host::processingTime = 0;
+}
+
+int main()
+{
+    // the transport logs every request and response
+    Serial.enabled = false;
+
+    testRefusedNotifications();
+    testPersistentRefusal();
+    testNoClient();
+    testCongestion();
+    testErrorWithoutBlocking();
+    testKeepaliveWithoutBlocking();
+
+    printf("# %u checks, %u failed\n", checks, failures);
+
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include <Arduino.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "fido2/ctap/ctap.h"
+
+#include "../check.h"
+#include "harness.h"
+
+/**
+ * Reassembly, fragmentation, error responses, keepalives and cancellation of the control point
+ */
+
+#define CMD_PING 0x81
+#define CMD_MSG 0x83
+#define CMD_CANCEL 0xbe
+#define CMD_ERROR 0xbf
+
+#define ERR_BUSY 0x06
+
+#define TIMEOUT_MS 1000
+
+uint32_t checks = 0;
+uint32_t failures = 0;
+
+static std::vector<uint8_t> randomPayload(const size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    esp_fill_random(payload.data(), payload.size());
+
+    return payload;
+}
+
+static bool isError(const Host::Frame &frame, const uint8_t error)
+{
+    return frame.cmd == CMD_ERROR && frame.payload.size() == 1 && frame.payload[0] == error;
+}
+
+/**
+ * Pings are echoed, so the request is reassembled and the response fragmented with the same length
+ */
+static void testPing()
+{
+    const uint16_t fragmentSizes[] = {20, 64, 182, 244, 512};
+    const size_t lengths[] = {0, 1, 16, 17, 61, 62, 100, 1000, FIDO2_MAX_MSG_SIZE - 3};
+
+    Host::Client client;
+
+    for (const uint16_t fragmentSize : fragmentSizes)
+    {
+        client.setFragmentSize(fragmentSize);
+
+        for (const size_t length : lengths)
+        {
+            const std::vector<uint8_t> payload = randomPayload(length);
+
+            const uint32_t notifications = client.getNotifications();
+            const uint16_t fragments = client.write(CMD_PING, payload.data(), payload.size());
+
+            Host::Frame frame;
+            CHECK(client.read(frame, TIMEOUT_MS));
+            CHECK(frame.cmd == CMD_PING);
+            CHECK(frame.payload == payload);
+            CHECK(client.getNotifications() - notifications == fragments);
+        }
+    }
+}
+
+/**
+ * Requests of the benchmark corpus reach the CTAP parser intact
+ */
+static void testMessages()
+{
+    std::vector<Benchmark::CorpusEntry> corpus;
+    Benchmark::buildCorpus(corpus);
+
+    Host::Client client;
+    client.setFragmentSize(182);
+
+    for (const Benchmark::CorpusEntry &entry : corpus)
+    {
+        if (entry.request.size() > FIDO2_MAX_MSG_SIZE - 3)
+        {
+            continue;
+        }
+
+        client.write(CMD_MSG, entry.request.data(), entry.request.size());
+
+        Host::Frame frame;
+        CHECK(client.read(frame, TIMEOUT_MS));
+        CHECK(frame.cmd == CMD_MSG);
+        CHECK(frame.payload.size() == 1 && frame.payload[0] == FIDO2::CTAP::CTAP2_OK);
+    }
+}
+
+/**
+ * Fragments that do not continue a frame are not answered, the next initialization fragment starts over
+ */
+static void testMalformed()
+{
+    Host::Client client;
+    client.setFragmentSize(20);
+
+    Host::Frame frame;
+
+    // continuation without the initialization fragment is ignored
+    const uint8_t first[20] = {0x00};
+    client.writeFragment(first, sizeof(first));
+    CHECK(!client.read(frame, 100));
+
+    // the second continuation fragment is lost, the frame never completes
+    const uint8_t initialization[20] = {CMD_PING, 0x00, 50};
+    const uint8_t third[20] = {0x02};
+    client.writeFragment(initialization, sizeof(initialization));
+    client.writeFragment(first, sizeof(first));
+    client.writeFragment(third, sizeof(third));
+    CHECK(!client.read(frame, 100));
+
+    // the receive buffer is reused by the next request
+    const std::vector<uint8_t> payload = randomPayload(100);
+    client.write(CMD_PING, payload.data(), payload.size());
+    CHECK(client.read(frame, TIMEOUT_MS));
+    CHECK(frame.cmd == CMD_PING && frame.payload == payload);
+}
+
+/**
+ * CANCEL aborts the request being processed, a request queued behind it is completed
+ */
+static void testCancel()
+{
+    Host::Client client;
+    client.setFragmentSize(64);
+
+    Host::processingTime = 300;
+
+    std::vector<Benchmark::CorpusEntry> corpus;
+    Benchmark::buildCorpus(corpus);
+    const std::vector<uint8_t> &request = corpus.back().request;
+
+    Host::Frame first;
+    Host::Frame second;
+
+    client.write(CMD_MSG, request.data(), request.size());
+    delay(50);
+    client.write(CMD_MSG, request.data(), request.size());
+    client.write(CMD_CANCEL, nullptr, 0);
+
+    CHECK(client.read(first, TIMEOUT_MS));
+    CHECK(first.cmd == CMD_MSG && first.payload.size() == 1 && first.payload[0] == FIDO2::CTAP::CTAP2_ERR_KEEPALIVE_CANCEL);
+    CHECK(client.read(second, TIMEOUT_MS));
+    CHECK(second.cmd == CMD_MSG && second.payload.size() == 1 && second.payload[0] == FIDO2::CTAP::CTAP2_OK);
+
+    // both receive buffers are in use, the third request is rejected
+    Host::Frame frame;
+    client.write(CMD_MSG, request.data(), request.size());
+    delay(50);
+    client.write(CMD_MSG, request.data(), request.size());
+    const uint32_t transactions = Host::transactions;
+    client.write(CMD_MSG, request.data(), request.size());
+    CHECK(client.read(frame, TIMEOUT_MS));
+    CHECK(isError(frame, ERR_BUSY));
+    // the rejected request does not raise the connection interval
+    CHECK(Host::transactions == transactions);
+    CHECK(client.read(frame, TIMEOUT_MS) && frame.cmd == CMD_MSG);
+    CHECK(client.read(frame, TIMEOUT_MS) && frame.cmd == CMD_MSG);
+
+    Host::processingTime = 0;
+}
+
+static void testKeepalive()
+{
+    Host::Client client;
+    client.setFragmentSize(64);
+
+    Host::processingTime = FIDO2_KEEPALIVE_INTERVAL * 2 + FIDO2_KEEPALIVE_INTERVAL / 2;
+
+    std::vector<Benchmark::CorpusEntry> corpus;
+    Benchmark::buildCorpus(corpus);
+    const std::vector<uint8_t> &request = corpus.back().request;
+
+    const uint32_t keepalives = client.getKeepalives();
+    client.write(CMD_MSG, request.data(), request.size());
+
+    Host::Frame frame;
+    CHECK(client.read(frame, Host::processingTime + TIMEOUT_MS));
+    CHECK(frame.cmd == CMD_MSG);
+    CHECK(client.getKeepalives() - keepalives == 2);
+
+    Host::processingTime = 0;
+}
+
+int main()
+{
+    // the transport logs every request and response
+    Serial.enabled = false;
+
+    testPing();
+    testMessages();
+    testMalformed();
+    testCancel();
+    testKeepalive();
+
+    printf("# %u checks, %u failed\n", checks, failures);
+
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file